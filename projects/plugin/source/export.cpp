@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <exception>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -11,13 +13,16 @@
 #include "common/zsheader.hpp"
 #include "system/system.hpp"
 
-using Logger = solution::shared::Logger;
-using System = solution::plugin::System;
+using Logger   = solution::shared::Logger;
+using Network  = solution::plugin::module::Network;
+using Settings = solution::plugin::Settings;
+using System   = solution::plugin::System;
 
 struct Source
 {
 	std::string file;
 	Config config;
+	Settings settings;
 	Graph segments;
 	std::vector < NitkaID > routes;
 	std::vector < Zapret > locks;
@@ -30,8 +35,54 @@ namespace
 {
 	std::shared_ptr < aim::CSerializer > serializer;
 	std::shared_ptr < Source > source;
+	std::shared_ptr < const Network > network;
 	std::shared_ptr < std::thread > worker;
 	std::shared_ptr < System > solver;
+	std::shared_ptr < const System::plan_t > plan;
+
+	std::vector < NitkaID > make_nitki(const System::charts_container_t & charts)
+	{
+		const unsigned int second_in_minute = 60U;
+
+		std::vector < NitkaID > nitki;
+
+		for (auto index = 0U; index < std::size(charts); ++index)
+		{
+			NitkaID nitka;
+
+			const auto & chart = charts[index];
+
+			if (source->is_forecast)
+			{
+				nitka.pgStartTime = static_cast < unsigned int > (chart.start) * second_in_minute;
+			}
+			else
+			{
+				nitka.StartTime = static_cast < unsigned int > (chart.start) * second_in_minute;
+			}
+			
+			nitka.type        = chart.type;
+			nitka.priority    = static_cast < int > (chart.priority);
+
+			for (const auto & point : chart.points)
+			{
+				if (source->is_forecast)
+				{
+					nitka.pgPoints.push_back(Point{ point.segment,
+						static_cast < unsigned int > (point.time) * second_in_minute, 0.0, 0.0, 0, false });
+				}
+				else
+				{
+					nitka.points.push_back(Point{ point.segment,
+						static_cast < unsigned int > (point.time) * second_in_minute, 0.0, 0.0, 0, false });
+				}
+			}
+
+			nitki.push_back(nitka);
+		}
+
+		return nitki;
+	}
 }
 
 const char * aimInit(const char * data) 
@@ -42,6 +93,12 @@ const char * aimInit(const char * data)
 	
 	serializer->deserializeInit(data, source->file, source->config, source->segments);
 
+	source->settings = solution::plugin::load_settings(source->file);
+
+	network = std::make_shared < const Network > (source->segments);
+
+	plan.reset();
+
 	return serializer->serializeInitResult(std::string());
 }
 
@@ -70,7 +127,23 @@ const char * aimStartWork(const char * data, void(*callback)(void))
 	serializer->deserializeStartWork(data, source->routes, source->locks, 
 		source->current_time, source->interval, source->is_forecast);
 
-	solver = std::make_shared < System > (source->segments, source->routes, source->locks);
+	auto settings = source->settings;
+
+	const int second_in_minute = 60;
+
+	if (source->interval >= second_in_minute)
+	{
+		settings.horizon_limit = std::min(settings.horizon_limit, 
+			static_cast < std::size_t > (source->interval / second_in_minute));
+	}
+
+	if (source->config.nvar1 > 0)
+	{
+		settings.variants_limit = static_cast < std::size_t > (source->config.nvar1);
+	}
+
+	solver = std::make_shared < System > (network, source->routes, source->locks, settings, 
+		(plan ? *plan : System::plan_t()));
 
 	worker = std::make_shared < std::thread > ([](
 		const std::vector < NitkaID > & routes, const std::vector < Zapret > & locks, 
@@ -90,56 +163,22 @@ const char * aimGetResult(const char * reserved)
 {
 	reserved; 
 
-	if (!solver->is_done())
+	const auto is_done = solver->is_done();
+
+	std::vector< std::vector < NitkaID > > result;
+
+	for (const auto & charts : solver->variants())
 	{
-		return serializer->serializeGetResult(std::string(), 0.0, {});
+		result.push_back(make_nitki(charts));
+	}
+
+	if (!is_done)
+	{
+		return serializer->serializeGetResult(std::string(), 0.0, result);
 	}
 	else
 	{
-		const unsigned int second_in_minute = 60U;
-
-		std::vector < NitkaID > nitki;
-
-		const auto & charts = solver->charts();
-
-		for (auto index = 0U; index < std::size(charts); ++index)
-		{
-			NitkaID nitka;
-
-			const auto & chart = charts[index];
-
-			if (source->is_forecast)
-			{
-				nitka.pgStartTime = static_cast < unsigned int > (chart.start) * second_in_minute;
-			}
-			else
-			{
-				nitka.StartTime = static_cast < unsigned int > (chart.start) * second_in_minute;
-			}
-			
-			nitka.type        = chart.type;
-			nitka.priority    = static_cast < int > (chart.priority);
-
-			for (const auto & point : chart.points)
-			{
-				if (source->is_forecast)
-				{
-					nitka.pgPoints.push_back(Point{ point.segment,
-						static_cast < unsigned int > (point.time) * second_in_minute, 0.0, 0.0, 0, false });
-				}
-				else
-				{
-					nitka.points.push_back(Point{ point.segment,
-						static_cast < unsigned int > (point.time) * second_in_minute, 0.0, 0.0, 0, false });
-				}
-			}
-
-			nitki.push_back(nitka);
-		}
-
-		std::vector< std::vector < NitkaID > > result;
-
-		result.push_back(nitki);
+		plan = std::make_shared < const System::plan_t > (solver->plan());
 
 		if (worker) 
 		{
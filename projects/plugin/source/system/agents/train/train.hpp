@@ -7,7 +7,9 @@
 #  pragma once
 #endif // #ifdef BOOST_HAS_PRAGMA_ONCE
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <stdexcept>
@@ -43,7 +45,7 @@ namespace solution
 			{
 			public:
 
-				enum class Command
+				enum class Command : std::uint8_t
 				{
 					stay,
 					skip,
@@ -55,14 +57,11 @@ namespace solution
 
 				Train() = default;
 
-				template < typename T, typename P, typename Enable =
-					std::enable_if_t <
-						std::is_convertible_v < T, std::string > && 
-						std::is_convertible_v < P, std::string > > >
-				explicit Train(std::size_t index_v, T && type_v, Direction direction_v, P && begin_v, P && end_v, double priority_v) :
-					index(index_v), type(std::forward < T > (type_v)), direction(direction_v),
-					begin(std::forward < P > (begin_v)), end(std::forward < P > (end_v)), priority(priority_v), 
-					command(Command::stay), m_deviation(0.0), m_segment(begin), m_segment_time(0LL)
+				explicit Train(std::size_t index_v, std::size_t type_v, Direction direction_v, 
+					std::size_t begin_v, std::size_t end_v, double priority_v) :
+					index(index_v), type(type_v), direction(direction_v),
+					begin(begin_v), end(end_v), priority(priority_v), 
+					command(Command::stay), m_segment(begin)
 				{
 					initialize();
 				}
@@ -75,40 +74,32 @@ namespace solution
 
 			public:
 
-				const auto deviation() const noexcept
-				{
-					return m_deviation;
-				}
-
-				const auto & segment() const noexcept
+				const auto segment() const noexcept
 				{
 					return m_segment;
 				}
 
 			public:
 
-				bool is_ready(std::time_t standard_time) const;
-
-				bool has_completed_movement() const;
-
-				bool has_completed_route(std::time_t standard_time) const;
-
-				void stay(std::time_t standard_time);
+				bool has_completed_movement() const noexcept
+				{
+					return (m_segment == end);
+				}
 
-				void move(const std::string & segment);
+				// the times on the segment are kept by the trains container
 
-				void set_segment_time(std::time_t segment_time) const noexcept
+				void move(std::size_t segment) noexcept
 				{
-					m_segment_time = segment_time;
+					m_segment = segment;
 				}
 
 			public: // const
 
 				std::size_t index;
-				std::string type;
+				std::size_t type;
 				Direction direction;
-				std::string begin;
-				std::string end;
+				std::size_t begin;
+				std::size_t end;
 				double priority;
 
 			public:
@@ -117,15 +108,11 @@ namespace solution
 
 			private:
 
-				double m_deviation;
-
-				std::string m_segment;
-
-			private:
-
-				mutable std::time_t m_segment_time;
+				std::size_t m_segment;
 			};
 
+			static_assert(std::is_trivially_copyable_v < Train > , "bad train type");
+
 		} // namespace agents
 
 	} // namespace plugin
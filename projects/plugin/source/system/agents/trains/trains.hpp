@@ -0,0 +1,253 @@
+#ifndef SOLUTION_PLUGIN_AGENTS_TRAINS_HPP
+#define SOLUTION_PLUGIN_AGENTS_TRAINS_HPP
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif // #ifdef BOOST_HAS_PRAGMA_ONCE
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../train/train.hpp"
+
+namespace solution
+{
+	namespace plugin
+	{
+		namespace agents
+		{
+			class trains_exception : public std::exception
+			{
+			public:
+
+				explicit trains_exception(const std::string & message) noexcept :
+					std::exception(message.c_str())
+				{}
+
+				explicit trains_exception(const char * const message) noexcept :
+					std::exception(message)
+				{}
+
+				~trains_exception() noexcept = default;
+			};
+
+			// trains of a node as a structure of arrays: the trains keep what
+			// the commands are decided by, the times on the current segments,
+			// the standard times of these segments and the priorities are kept
+			// in parallel lanes, so that all trains tick forward in one flat loop
+
+			class Trains
+			{
+			private:
+
+				using trains_container_t = std::vector < Train > ;
+
+				using times_container_t = std::vector < std::time_t > ;
+
+				using priorities_container_t = std::vector < double > ;
+
+			public:
+
+				Trains() = default;
+
+				~Trains() noexcept = default;
+
+			public:
+
+				auto size() const noexcept
+				{
+					return std::size(m_trains);
+				}
+
+				bool empty() const noexcept
+				{
+					return m_trains.empty();
+				}
+
+				auto begin() noexcept
+				{
+					return std::begin(m_trains);
+				}
+
+				auto begin() const noexcept
+				{
+					return std::cbegin(m_trains);
+				}
+
+				auto end() noexcept
+				{
+					return std::end(m_trains);
+				}
+
+				auto end() const noexcept
+				{
+					return std::cend(m_trains);
+				}
+
+				Train & operator[](std::size_t position) noexcept
+				{
+					return m_trains[position];
+				}
+
+				const Train & operator[](std::size_t position) const noexcept
+				{
+					return m_trains[position];
+				}
+
+				void swap(Trains & other) noexcept
+				{
+					m_trains.swap(other.m_trains);
+
+					m_segment_times .swap(other.m_segment_times);
+					m_standard_times.swap(other.m_standard_times);
+					m_priorities    .swap(other.m_priorities);
+				}
+
+			public:
+
+				auto segment_time(std::size_t position) const noexcept
+				{
+					return m_segment_times[position];
+				}
+
+				auto standard_time(std::size_t position) const noexcept
+				{
+					return m_standard_times[position];
+				}
+
+				bool is_ready(std::size_t position) const noexcept
+				{
+					return (m_segment_times[position] >= m_standard_times[position]);
+				}
+
+				bool has_completed_route(std::size_t position) const noexcept
+				{
+					return (m_trains[position].has_completed_movement() && is_ready(position));
+				}
+
+			public:
+
+				void insert(std::size_t position, const Train & train, std::time_t standard_time, std::time_t segment_time = 0LL)
+				{
+					m_trains.insert(std::next(std::begin(m_trains), position), train);
+
+					m_segment_times .insert(std::next(std::begin(m_segment_times ), position), segment_time);
+					m_standard_times.insert(std::next(std::begin(m_standard_times), position), standard_time);
+					m_priorities    .insert(std::next(std::begin(m_priorities    ), position), train.priority);
+				}
+
+				void push_back(const Train & train, std::time_t standard_time, std::time_t segment_time = 0LL)
+				{
+					insert(size(), train, standard_time, segment_time);
+				}
+
+				template < typename P >
+				void erase_if(P predicate)
+				{
+					auto last = 0U;
+
+					for (auto position = 0U; position < size(); ++position)
+					{
+						if (!predicate(m_trains[position]))
+						{
+							m_trains        [last] = m_trains        [position];
+							m_segment_times [last] = m_segment_times [position];
+							m_standard_times[last] = m_standard_times[position];
+							m_priorities    [last] = m_priorities    [position];
+
+							++last;
+						}
+					}
+
+					m_trains        .resize(last);
+					m_segment_times .resize(last);
+					m_standard_times.resize(last);
+					m_priorities    .resize(last);
+				}
+
+				void move(std::size_t position, std::size_t segment, std::time_t standard_time) noexcept
+				{
+					m_trains[position].move(segment);
+
+					m_standard_times[position] = standard_time;
+
+					m_segment_times[position] = 0LL;
+				}
+
+				void set_segment_time(std::size_t position, std::time_t segment_time) noexcept
+				{
+					m_segment_times[position] = segment_time;
+				}
+
+			public:
+
+				// all trains tick forward, returns the deviation added for the
+				// time over the standard ones, the loop runs over the lanes only
+
+				double stay() noexcept
+				{
+					const auto size = std::size(m_segment_times);
+
+					const auto standard_times = m_standard_times.data();
+					const auto priorities     = m_priorities    .data();
+
+					auto segment_times = m_segment_times.data();
+
+					auto deviation = 0.0;
+
+					for (std::size_t i = 0U; i < size; ++i)
+					{
+						const auto segment_time = ++segment_times[i];
+
+						deviation += priorities[i] * static_cast < double > (
+							std::max < std::time_t > (segment_time - standard_times[i], 0LL));
+					}
+
+					return deviation;
+				}
+
+				double stay(std::time_t duration) noexcept
+				{
+					auto deviation = 0.0;
+
+					for (std::size_t i = 0U; i < std::size(m_segment_times); ++i)
+					{
+						const auto first = std::max < std::time_t > (m_segment_times[i] + 1LL, m_standard_times[i] + 1LL);
+						const auto last  = m_segment_times[i] + duration;
+
+						m_segment_times[i] += duration;
+
+						if (last >= first)
+						{
+							deviation += m_priorities[i] * (first + last - 2LL * m_standard_times[i]) * (last - first + 1LL) / 2.0;
+						}
+					}
+
+					return deviation;
+				}
+
+			private:
+
+				trains_container_t m_trains;
+
+				times_container_t m_segment_times;
+				times_container_t m_standard_times;
+
+				priorities_container_t m_priorities;
+			};
+
+		} // namespace agents
+
+	} // namespace plugin
+
+} // namespace solution
+
+#endif // #ifndef SOLUTION_PLUGIN_AGENTS_TRAINS_HPP
\ No newline at end of file
@@ -46,6 +46,75 @@ namespace solution
 			}
 		}
 
+		Settings load_settings(const std::string & path)
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				Settings settings;
+
+				std::fstream fin(path, std::ios::in);
+
+				if (!fin)
+				{
+					return settings;
+				}
+
+				boost::property_tree::ptree tree;
+
+				try
+				{
+					boost::property_tree::read_ini(fin, tree);
+				}
+				catch (const boost::property_tree::ini_parser_error & exception)
+				{
+					logger.write(shared::Logger::Severity::error, exception.what());
+
+					return settings;
+				}
+
+				settings.threads_limit = std::max(tree.get("system.threads_limit", settings.threads_limit), std::size_t(1U));
+
+				settings.branches_limit = std::min(tree.get("system.branches_limit", settings.branches_limit), std::size_t(16U));
+
+				settings.strategies_limit = std::max(tree.get("system.strategies_limit", settings.strategies_limit), std::size_t(1U));
+
+				settings.strategies_initial = std::clamp(tree.get("system.strategies_initial", 
+					settings.strategies_initial), std::size_t(1U), settings.strategies_limit);
+
+				settings.strategies_factor = std::max(tree.get("system.strategies_factor", settings.strategies_factor), std::size_t(2U));
+
+				settings.time_limit = std::max(tree.get("system.time_limit", settings.time_limit), 0.0);
+
+				settings.horizon_limit = std::max(tree.get("system.horizon_limit", settings.horizon_limit), std::size_t(1U));
+
+				settings.variants_limit = std::max(tree.get("system.variants_limit", settings.variants_limit), std::size_t(1U));
+
+				settings.variants_difference = std::max(tree.get("system.variants_difference", settings.variants_difference), std::size_t(1U));
+
+				settings.neighbourhoods_limit = tree.get("system.neighbourhoods_limit", settings.neighbourhoods_limit);
+
+				settings.neighbourhood_size = std::max(tree.get("system.neighbourhood_size", settings.neighbourhood_size), std::size_t(1U));
+
+				settings.neighbourhood_strategies = std::max(tree.get("system.neighbourhood_strategies", settings.neighbourhood_strategies), std::size_t(1U));
+
+				settings.horizon_window = tree.get("system.horizon_window", settings.horizon_window);
+
+				settings.horizon_step = std::max(tree.get("system.horizon_step", settings.horizon_step), std::size_t(1U));
+
+				settings.has_regions = tree.get("system.has_regions", settings.has_regions);
+
+				settings.rollouts_limit = tree.get("system.rollouts_limit", settings.rollouts_limit);
+
+				return settings;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < std::runtime_error > (logger, exception);
+			}
+		}
+
 	} // namespace plugin
 
 } // namespace solution
\ No newline at end of file
@@ -7,12 +7,18 @@
 #  pragma once
 #endif // #ifdef BOOST_HAS_PRAGMA_ONCE
 
+#include <algorithm>
+#include <cstddef>
 #include <exception>
+#include <fstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 #include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -49,6 +55,43 @@ namespace solution
 			error
 		};
 
+		struct Settings
+		{
+			std::size_t threads_limit = std::max(std::thread::hardware_concurrency(), 1U);
+
+			std::size_t branches_limit = 2U;
+
+			std::size_t strategies_limit = 4U;
+
+			std::size_t strategies_initial = 1U;
+
+			std::size_t strategies_factor = 2U;
+
+			double time_limit = 0.0;
+
+			std::size_t horizon_limit = 1440U;
+
+			std::size_t variants_limit = 1U;
+
+			std::size_t variants_difference = 2U;
+
+			std::size_t neighbourhoods_limit = 0U;
+
+			std::size_t neighbourhood_size = 4U;
+
+			std::size_t neighbourhood_strategies = 16U;
+
+			std::size_t horizon_window = 0U;
+
+			std::size_t horizon_step = 15U;
+
+			bool has_regions = false;
+
+			std::size_t rollouts_limit = 0U;
+		};
+
+		Settings load_settings(const std::string & path);
+
 	} // namespace plugin
 
 } // namespace solution
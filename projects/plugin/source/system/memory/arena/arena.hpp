@@ -0,0 +1,218 @@
+#ifndef SOLUTION_PLUGIN_MEMORY_ARENA_HPP
+#define SOLUTION_PLUGIN_MEMORY_ARENA_HPP
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif // #ifdef BOOST_HAS_PRAGMA_ONCE
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "../../../../../shared/source/logger/logger.hpp"
+
+namespace solution
+{
+	namespace plugin
+	{
+		namespace memory
+		{
+			class arena_exception : public std::exception
+			{
+			public:
+
+				explicit arena_exception(const std::string & message) noexcept :
+					std::exception(message.c_str())
+				{}
+
+				explicit arena_exception(const char * const message) noexcept :
+					std::exception(message)
+				{}
+
+				~arena_exception() noexcept = default;
+			};
+
+			// objects are placed into contiguous blocks of cells, destroyed
+			// cells are recycled through the intrusive free list, all blocks
+			// are released at once by clear() or by the destructor
+
+			template < typename T, std::size_t N = 1024U >
+			class Arena : private boost::noncopyable
+			{
+			private:
+
+				struct Cell
+				{
+					alignas(T) unsigned char storage[sizeof(T)];
+
+					Cell * next = nullptr;
+
+					bool is_used = false;
+				};
+
+			private:
+
+				using block_t = std::unique_ptr < Cell[] > ;
+
+				using blocks_container_t = std::vector < block_t > ;
+
+			public:
+
+				Arena() noexcept : m_position(N), m_free(nullptr), m_size(0U)
+				{}
+
+				~Arena() noexcept
+				{
+					try
+					{
+						clear();
+					}
+					catch (...)
+					{
+						// std::abort();
+					}
+				}
+
+			public:
+
+				auto size() const noexcept
+				{
+					return m_size;
+				}
+
+			public:
+
+				template < typename ... Types >
+				T * create(Types && ... args)
+				{
+					auto cell = m_free;
+
+					if (cell)
+					{
+						m_free = cell->next;
+					}
+					else
+					{
+						if (m_position == N)
+						{
+							make_block();
+						}
+
+						cell = &m_blocks.back()[m_position++];
+					}
+
+					auto object = new (cell->storage) T(std::forward < Types > (args)...);
+
+					cell->is_used = true;
+
+					++m_size;
+
+					return object;
+				}
+
+				void destroy(T * object) noexcept
+				{
+					if (object)
+					{
+						auto cell = reinterpret_cast < Cell * > (object);
+
+						object->~T();
+
+						cell->is_used = false;
+
+						cell->next = m_free;
+
+						m_free = cell;
+
+						--m_size;
+					}
+				}
+
+				void clear();
+
+			private:
+
+				void make_block();
+
+			private:
+
+				blocks_container_t m_blocks;
+
+				std::size_t m_position;
+
+				Cell * m_free;
+
+				std::size_t m_size;
+			};
+
+			template < typename T, std::size_t N >
+			void Arena < T, N > ::clear()
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					if constexpr (!std::is_trivially_destructible_v < T >)
+					{
+						for (auto i = 0U; i < std::size(m_blocks); ++i)
+						{
+							const auto size = ((i + 1U == std::size(m_blocks)) ? m_position : N);
+
+							for (auto j = 0U; j < size; ++j)
+							{
+								if (m_blocks[i][j].is_used)
+								{
+									reinterpret_cast < T * > (m_blocks[i][j].storage)->~T();
+								}
+							}
+						}
+					}
+
+					m_blocks.clear();
+
+					m_position = N;
+
+					m_free = nullptr;
+
+					m_size = 0U;
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < arena_exception > (logger, exception);
+				}
+			}
+
+			template < typename T, std::size_t N >
+			void Arena < T, N > ::make_block()
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					m_blocks.push_back(std::make_unique < Cell[] > (N));
+
+					m_position = 0U;
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < arena_exception > (logger, exception);
+				}
+			}
+
+		} // namespace memory
+
+	} // namespace plugin
+
+} // namespace solution
+
+#endif // #ifndef SOLUTION_PLUGIN_MEMORY_ARENA_HPP
\ No newline at end of file
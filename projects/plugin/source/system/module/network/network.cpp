@@ -0,0 +1,352 @@
+#include "network.hpp"
+
+namespace solution
+{
+	namespace plugin
+	{
+		namespace module
+		{
+			void Network::initialize(const Graph & graph)
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					make_types(graph);
+
+					make_segments(graph);
+
+					make_lines(graph);
+
+					make_reachability();
+
+					make_chains();
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			void Network::make_types(const Graph & graph)
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					m_types.emplace(default_type, 0U);
+
+					for (const auto & node : graph.nodes)
+					{
+						for (const auto & record : node.standard_times)
+						{
+							m_types.emplace(record.type, std::size(m_types));
+						}
+					}
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			void Network::make_segments(const Graph & graph)
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					m_segments.reserve(std::size(graph.nodes));
+
+					for (const auto & node : graph.nodes)
+					{
+						const auto id = std::size(m_segments);
+
+						if (!m_indexes.emplace(node.name, id).second)
+						{
+							continue;
+						}
+
+						m_segments.emplace_back(id, node.name);
+
+						Segment::times_container_t standard_times(std::size(m_types), Segment::Time{ 0LL, 0LL });
+
+						std::vector < bool > has_standard_times(std::size(m_types), false);
+
+						for (const auto & record : node.standard_times)
+						{
+							const auto type = m_types.at(record.type);
+
+							standard_times[type] = Segment::Time{ 
+								record.time / seconds_in_minute, record.timeRev / seconds_in_minute };
+
+							has_standard_times[type] = true;
+						}
+
+						const auto default_id = m_types.at(default_type);
+
+						for (auto type = 0U; type < std::size(standard_times); ++type)
+						{
+							if (!has_standard_times[type])
+							{
+								standard_times[type] = standard_times[default_id];
+							}
+						}
+
+						m_segments.back().set_standard_times(std::move(standard_times));
+					}
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			void Network::make_lines(const Graph & graph)
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					for (const auto & line : graph.lines)
+					{
+						switch (line.srcDirection)
+						{
+						case Line::LineDirection::Direction0:
+						{
+							m_segments[index(line.srcNode)].append_northern_adjacent_segment(index(line.dstNode));
+
+							break;
+						}
+						case Line::LineDirection::Direction1:
+						{
+							m_segments[index(line.srcNode)].append_southern_adjacent_segment(index(line.dstNode));
+
+							break;
+						}
+						default:
+						{
+							throw std::runtime_error("unknown direction");
+						}
+						}
+					}
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			void Network::make_reachability()
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					const auto size = std::size(m_segments);
+
+					m_northern_reachability.assign(size, boost::dynamic_bitset <> (size));
+					m_southern_reachability.assign(size, boost::dynamic_bitset <> (size));
+
+					std::deque < std::pair < std::size_t, Direction > > segments;
+
+					std::vector < bool > visited_segments(size);
+
+					for (auto begin = 0U; begin < size; ++begin)
+					{
+						segments.push_back(std::make_pair(begin, Direction::north));
+						segments.push_back(std::make_pair(begin, Direction::south));
+
+						visited_segments.assign(size, false);
+
+						visited_segments[begin] = true;
+
+						m_northern_reachability[begin].set(begin);
+
+						while (!segments.empty())
+						{
+							const auto segment = segments.front();
+
+							segments.pop_front();
+
+							auto & reachability = ((segment.second == Direction::north) ? 
+								m_northern_reachability[begin] : m_southern_reachability[begin]);
+
+							const auto & next_segments = ((segment.second == Direction::north) ?
+								m_segments[segment.first].northern_adjacent_segments() :
+								m_segments[segment.first].southern_adjacent_segments());
+
+							for (const auto next_segment : next_segments)
+							{
+								if (!visited_segments[next_segment])
+								{
+									segments.push_back(std::make_pair(next_segment, segment.second));
+
+									reachability.set(next_segment);
+
+									visited_segments[next_segment] = true;
+								}
+							}
+						}
+					}
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			void Network::make_chains()
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					const auto size = std::size(m_segments);
+
+					std::vector < std::size_t > visits(size, npos);
+
+					for (const auto direction : { Direction::north, Direction::south })
+					{
+						auto & chains = ((direction == Direction::north) ? m_northern_chains : m_southern_chains);
+
+						chains.assign(size, Chain{ {}, npos });
+
+						for (auto begin = 0U; begin < size; ++begin)
+						{
+							auto & chain = chains[begin];
+
+							std::size_t segment = begin;
+
+							visits[segment] = begin;
+
+							while (std::size(m_segments[segment].adjacent_segments(direction)) == 1U)
+							{
+								segment = m_segments[segment].adjacent_segments(direction).front();
+
+								if (visits[segment] == begin)
+								{
+									segment = npos;
+
+									break;
+								}
+
+								visits[segment] = begin;
+
+								chain.segments.push_back(segment);
+							}
+
+							chain.end = segment;
+
+							chain.segments.shrink_to_fit();
+						}
+
+						visits.assign(size, npos);
+					}
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			// minimum sum of standard times of the segments to be passed by the
+			// train of the given type from each segment to the end, the segment
+			// it stays on is not included, infinity if the end is unreachable
+
+			Network::distances_container_t Network::make_distances(
+				std::size_t end, std::size_t type, Direction direction) const
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					const auto size = std::size(m_segments);
+
+					std::vector < std::vector < std::size_t > > previous_segments(size);
+
+					for (const auto & segment : m_segments)
+					{
+						for (const auto next_segment : segment.adjacent_segments(direction))
+						{
+							previous_segments[next_segment].push_back(segment.id);
+						}
+					}
+
+					distances_container_t distances(size, infinity);
+
+					using item_t = std::pair < std::time_t, std::size_t > ;
+
+					std::priority_queue < item_t, std::vector < item_t >, std::greater < item_t > > segments;
+
+					distances[end] = 0LL;
+
+					segments.push(std::make_pair(0LL, end));
+
+					while (!segments.empty())
+					{
+						const auto [distance, segment] = segments.top();
+
+						segments.pop();
+
+						if (distance > distances[segment])
+						{
+							continue;
+						}
+
+						const auto next_distance = distance + m_segments[segment].standard_time(type, direction);
+
+						for (const auto previous_segment : previous_segments[segment])
+						{
+							if (next_distance < distances[previous_segment])
+							{
+								distances[previous_segment] = next_distance;
+
+								segments.push(std::make_pair(next_distance, previous_segment));
+							}
+						}
+					}
+
+					return distances;
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			std::size_t Network::index(const std::string & name) const
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					return m_indexes.at(name);
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+			std::size_t Network::type(const std::string & name) const
+			{
+				RUN_LOGGER(logger);
+
+				try
+				{
+					const auto iterator = m_types.find(name);
+
+					return ((iterator == std::end(m_types)) ? m_types.at(default_type) : iterator->second);
+				}
+				catch (const std::exception & exception)
+				{
+					shared::catch_handler < network_exception > (logger, exception);
+				}
+			}
+
+		} // namespace module
+
+	} // namespace plugin
+
+} // namespace solution
\ No newline at end of file
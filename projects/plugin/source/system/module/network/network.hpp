@@ -0,0 +1,194 @@
+#ifndef SOLUTION_PLUGIN_MODULE_NETWORK_HPP
+#define SOLUTION_PLUGIN_MODULE_NETWORK_HPP
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif // #ifdef BOOST_HAS_PRAGMA_ONCE
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "../segment/segment.hpp"
+
+#include "../../config/config.hpp"
+
+#include "../../../common/zsheader.hpp"
+
+#include "../../../../../shared/source/logger/logger.hpp"
+
+namespace solution
+{
+	namespace plugin
+	{
+		namespace module
+		{
+			class network_exception : public std::exception
+			{
+			public:
+
+				explicit network_exception(const std::string & message) noexcept :
+					std::exception(message.c_str())
+				{}
+
+				explicit network_exception(const char * const message) noexcept :
+					std::exception(message)
+				{}
+
+				~network_exception() noexcept = default;
+			};
+
+			class Network
+			{
+			public:
+
+				using segments_container_t = std::vector < Segment > ;
+
+				using indexes_container_t = std::unordered_map < std::string, std::size_t > ;
+
+				using reachability_container_t = std::vector < boost::dynamic_bitset <> > ;
+
+			public:
+
+				// segments passed from the given one in the given direction while
+				// there is the only way forward, end is the last of them (or the
+				// given one itself), which has several or no adjacent segments,
+				// or npos if the single track is closed into a loop
+
+				struct Chain
+				{
+					Segment::segments_container_t segments;
+
+					std::size_t end;
+				};
+
+			public:
+
+				using chains_container_t = std::vector < Chain > ;
+
+				using distances_container_t = std::vector < std::time_t > ;
+
+			public:
+
+				static inline const std::size_t npos = static_cast < std::size_t > (-1);
+
+				static inline const std::time_t infinity = std::numeric_limits < std::time_t > ::max();
+
+			public:
+
+				explicit Network(const Graph & graph)
+				{
+					initialize(graph);
+				}
+
+				~Network() noexcept = default;
+
+			private:
+
+				void initialize(const Graph & graph);
+
+				void make_types(const Graph & graph);
+
+				void make_segments(const Graph & graph);
+
+				void make_lines(const Graph & graph);
+
+				void make_reachability();
+
+				void make_chains();
+
+			public:
+
+				const auto & segments() const noexcept
+				{
+					return m_segments;
+				}
+
+				const auto & segment(std::size_t id) const noexcept
+				{
+					return m_segments[id];
+				}
+
+				std::size_t index(const std::string & name) const;
+
+				std::size_t type(const std::string & name) const;
+
+			public:
+
+				// direction in which end is reached from begin by the breadth-first
+				// search in both directions, Direction::error if it is unreachable
+
+				Direction direction(std::size_t begin, std::size_t end) const noexcept
+				{
+					return (m_northern_reachability[begin].test(end) ? Direction::north :
+						(m_southern_reachability[begin].test(end) ? Direction::south : Direction::error));
+				}
+
+				bool is_reachable(std::size_t begin, std::size_t end) const noexcept
+				{
+					return (direction(begin, end) != Direction::error);
+				}
+
+				distances_container_t make_distances(std::size_t end, std::size_t type, Direction direction) const;
+
+				const Chain & chain(std::size_t segment, Direction direction) const
+				{
+					switch (direction)
+					{
+					case Direction::north:
+					{
+						return m_northern_chains[segment];
+					}
+					case Direction::south:
+					{
+						return m_southern_chains[segment];
+					}
+					default:
+					{
+						throw network_exception("unknown direction");
+					}
+					}
+				}
+
+			private:
+
+				static inline const std::string default_type = "train";
+
+				static const std::time_t seconds_in_minute = 60LL;
+
+			private:
+
+				segments_container_t m_segments;
+
+				indexes_container_t m_indexes;
+
+				indexes_container_t m_types;
+
+				reachability_container_t m_northern_reachability;
+
+				reachability_container_t m_southern_reachability;
+
+				chains_container_t m_northern_chains;
+
+				chains_container_t m_southern_chains;
+			};
+
+		} // namespace module
+
+	} // namespace plugin
+
+} // namespace solution
+
+#endif // #ifndef SOLUTION_PLUGIN_MODULE_NETWORK_HPP
\ No newline at end of file
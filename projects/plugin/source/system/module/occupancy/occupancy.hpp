@@ -0,0 +1,95 @@
+#ifndef SOLUTION_PLUGIN_MODULE_OCCUPANCY_HPP
+#define SOLUTION_PLUGIN_MODULE_OCCUPANCY_HPP
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif // #ifdef BOOST_HAS_PRAGMA_ONCE
+
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "../../config/config.hpp"
+
+#include "../../../../../shared/source/logger/logger.hpp"
+
+namespace solution
+{
+	namespace plugin
+	{
+		namespace module
+		{
+			class occupancy_exception : public std::exception
+			{
+			public:
+
+				explicit occupancy_exception(const std::string & message) noexcept :
+					std::exception(message.c_str())
+				{}
+
+				explicit occupancy_exception(const char * const message) noexcept :
+					std::exception(message)
+				{}
+
+				~occupancy_exception() noexcept = default;
+			};
+
+			class Occupancy // TODO: add reduced speed
+			{
+			private:
+
+				using segments_container_t = boost::dynamic_bitset <> ;
+
+			public:
+
+				explicit Occupancy(std::size_t size) :
+					m_occupied_segments(size), m_locked_segments(size)
+				{}
+
+				~Occupancy() noexcept = default;
+
+			public:
+
+				void train_arrived(std::size_t segment) noexcept
+				{
+					m_occupied_segments.set(segment);
+				}
+
+				void train_departured(std::size_t segment) noexcept
+				{
+					m_occupied_segments.reset(segment);
+				}
+
+				void lock(std::size_t segment) noexcept
+				{
+					m_locked_segments.set(segment);
+				}
+
+				void unlock(std::size_t segment) noexcept
+				{
+					m_locked_segments.reset(segment);
+				}
+
+				bool is_available(std::size_t segment) const noexcept
+				{
+					return !(m_occupied_segments[segment] || m_locked_segments[segment]);
+				}
+
+			private:
+
+				segments_container_t m_occupied_segments;
+				segments_container_t m_locked_segments;
+			};
+
+		} // namespace module
+
+	} // namespace plugin
+
+} // namespace solution
+
+#endif // #ifndef SOLUTION_PLUGIN_MODULE_OCCUPANCY_HPP
\ No newline at end of file
@@ -6,84 +6,7 @@ namespace solution
 	{
 		namespace module
 		{
-			std::time_t Segment::standard_time(std::string type, Direction direction) const
-			{
-				RUN_LOGGER(logger);
-
-				try
-				{
-					if (m_standard_times.find(type) == std::end(m_standard_times))
-					{
-						type = "train";
-					}
-
-					switch (direction)
-					{
-					case Direction::north:
-					{
-						return m_standard_times.at(type).time_to_north;
-					}
-					case Direction::south:
-					{
-						return m_standard_times.at(type).time_to_south;
-					}
-					default:
-					{
-						throw std::runtime_error("unknown direction");
-					}
-					}
-
-					return 0LL;
-				}
-				catch (const std::exception & exception)
-				{
-					shared::catch_handler < segment_exception > (logger, exception);
-				}
-			}
-
-			void Segment::train_arrived() const
-			{
-				RUN_LOGGER(logger);
-
-				try
-				{
-					m_has_train = true;
-				}
-				catch (const std::exception & exception)
-				{
-					shared::catch_handler < segment_exception > (logger, exception);
-				}
-			}
-
-			void Segment::train_departured() const
-			{
-				RUN_LOGGER(logger);
-
-				try
-				{
-					m_has_train = false;
-				}
-				catch (const std::exception & exception)
-				{
-					shared::catch_handler < segment_exception > (logger, exception);
-				}
-			}
-
-			bool Segment::is_available() const
-			{
-				RUN_LOGGER(logger);
-
-				try
-				{
-					return (!m_has_train && state != State::locked);
-				}
-				catch (const std::exception & exception)
-				{
-					shared::catch_handler < segment_exception > (logger, exception);
-				}
-			}
-
-			void Segment::append_northern_adjacent_segment(const std::string & segment)
+			void Segment::append_northern_adjacent_segment(std::size_t segment)
 			{
 				RUN_LOGGER(logger);
 
@@ -104,7 +27,7 @@ namespace solution
 				}
 			}
 
-			void Segment::append_southern_adjacent_segment(const std::string & segment)
+			void Segment::append_southern_adjacent_segment(std::size_t segment)
 			{
 				RUN_LOGGER(logger);
 
@@ -125,13 +48,15 @@ namespace solution
 				}
 			}
 
-			void Segment::set_standard_time(const std::string & type, Time time)
+			void Segment::set_standard_times(times_container_t && standard_times)
 			{
 				RUN_LOGGER(logger);
 
 				try
 				{
-					m_standard_times[type] = time;
+					m_standard_times = std::move(standard_times);
+
+					m_standard_times.shrink_to_fit();
 				}
 				catch (const std::exception & exception)
 				{
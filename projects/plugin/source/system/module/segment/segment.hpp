@@ -13,7 +13,7 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../config/config.hpp"
@@ -45,15 +45,7 @@ namespace solution
 			{
 			public:
 
-				enum class State // TODO: add reduced speed
-				{
-					normal,
-					locked
-				};
-
-			public:
-
-				using segments_container_t = std::vector < std::string > ;
+				using segments_container_t = std::vector < std::size_t > ;
 
 			public:
 
@@ -63,12 +55,16 @@ namespace solution
 					std::time_t time_to_south;
 				};
 
+			public:
+
+				using times_container_t = std::vector < Time > ;
+
 			public:
 
 				template < typename Name, typename Enable = 
 					std::enable_if_t < std::is_convertible_v < Name, std::string > > >
-				explicit Segment(Name && name_v) :
-					name(std::forward < Name > (name_v)), state(State::normal), m_has_train(false)
+				explicit Segment(std::size_t id_v, Name && name_v) :
+					id(id_v), name(std::forward < Name > (name_v))
 				{}
 
 				~Segment() noexcept = default;
@@ -85,40 +81,63 @@ namespace solution
 					return m_southern_adjacent_segments;
 				}
 
-				std::time_t standard_time(std::string type, Direction direction) const;
-
-			public:
-
-				void train_arrived() const;
+				const auto & adjacent_segments(Direction direction) const
+				{
+					switch (direction)
+					{
+					case Direction::north:
+					{
+						return m_northern_adjacent_segments;
+					}
+					case Direction::south:
+					{
+						return m_southern_adjacent_segments;
+					}
+					default:
+					{
+						throw segment_exception("unknown direction");
+					}
+					}
+				}
 
-				void train_departured() const;
+				std::time_t standard_time(std::size_t type, Direction direction) const
+				{
+					switch (direction)
+					{
+					case Direction::north:
+					{
+						return m_standard_times[type].time_to_north;
+					}
+					case Direction::south:
+					{
+						return m_standard_times[type].time_to_south;
+					}
+					default:
+					{
+						throw segment_exception("unknown direction");
+					}
+					}
+				}
 
-				bool is_available() const;
+			public:
 
-				void append_northern_adjacent_segment(const std::string & segment);
+				void append_northern_adjacent_segment(std::size_t segment);
 
-				void append_southern_adjacent_segment(const std::string & segment);
+				void append_southern_adjacent_segment(std::size_t segment);
 
-				void set_standard_time(const std::string & type, Time time);
+				void set_standard_times(times_container_t && standard_times);
 
 			public: // const
 
+				std::size_t id;
 				std::string name;
 
-			public:
-
-				State state;
-
 			private:
 
 				segments_container_t m_northern_adjacent_segments;
 				segments_container_t m_southern_adjacent_segments;
 
-				std::unordered_map < std::string, Time > m_standard_times;
-
-			private:
-
-				mutable bool m_has_train;
+				times_container_t m_standard_times;
 			};
 
 		} // namespace module
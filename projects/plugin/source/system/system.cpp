@@ -6,18 +6,20 @@ namespace solution
 	{
 		using Severity = shared::Logger::Severity;
 
-		void System::Node::update_deviation()
+		System::Occupancy & System::Node::modify_occupancy()
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				deviation = 0.0;
-
-				for (const auto & train : trains)
+				if (has_shared_occupancy)
 				{
-					deviation += train.deviation();
+					occupancy = std::make_shared < Occupancy > (*occupancy);
+
+					has_shared_occupancy = false;
 				}
+
+				return *occupancy;
 			}
 			catch (const std::exception & exception)
 			{
@@ -26,39 +28,28 @@ namespace solution
 		}
 
 		void System::initialize(
-			const input_segments_t & input_segments,
-			const input_routes_t   & input_routes,
-			const input_locks_t    & input_locks)
+			const input_routes_t & input_routes,
+			const input_locks_t  & input_locks,
+			const plan_t & plan)
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				make_segments(input_segments);
-
-				m_head = new Node;
-
-				m_head->segments = m_segments;
-
-				m_leafs.push_back(m_head);
+				m_origin.occupancy = std::make_shared < Occupancy > (std::size(m_network->segments()));
 
 				make_routes(input_routes);
 
 				make_locks(input_locks);
-			}
-			catch (const std::exception & exception)
-			{
-				shared::catch_handler < system_exception > (logger, exception);
-			}
-		}
 
-		void System::uninitialize()
-		{
-			RUN_LOGGER(logger);
+				make_plan(plan);
 
-			try
-			{
-				// clear(m_head); // TODO
+				if (m_settings.has_regions)
+				{
+					make_regions(input_routes, input_locks, plan);
+				}
+
+				make_head();
 			}
 			catch (const std::exception & exception)
 			{
@@ -66,46 +57,17 @@ namespace solution
 			}
 		}
 
-		void System::make_segments(const input_segments_t & input_segments)
+		void System::uninitialize()
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				for (const auto & node : input_segments.nodes)
-				{
-					m_segments.emplace(std::piecewise_construct, 
-						std::forward_as_tuple(node.name), std::forward_as_tuple(node.name));
-
-					for (const auto & record : node.standard_times)
-					{
-						m_segments.at(node.name).set_standard_time(record.type, Segment::Time{ 
-							record.time / seconds_in_minute, record.timeRev / seconds_in_minute });
-					}
-				}
-
-				for (const auto & line : input_segments.lines)
-				{
-					switch (line.srcDirection)
-					{
-					case Line::LineDirection::Direction0:
-					{
-						m_segments.at(line.srcNode).append_northern_adjacent_segment(line.dstNode);
+				m_leafs.clear();
 
-						break;
-					}
-					case Line::LineDirection::Direction1:
-					{
-						m_segments.at(line.srcNode).append_southern_adjacent_segment(line.dstNode);
+				m_head = nullptr;
 
-						break;
-					}
-					default:
-					{
-						throw std::runtime_error("unknown direction");
-					}
-					}
-				}
+				m_nodes.clear();
 			}
 			catch (const std::exception & exception)
 			{
@@ -121,17 +83,36 @@ namespace solution
 			{
 				std::set < std::time_t > starts;
 
+				std::map < std::tuple < std::size_t, std::size_t, Direction >, std::size_t > distances;
+
 				auto index = 0U;
 
 				for (const auto & input_route : input_routes)
 				{
 					starts.insert(input_route.StartTime / seconds_in_minute);
 
-					const auto begin = input_route.points.front().name;
-					const auto end   = input_route.points.back ().name;
+					const auto begin = m_network->index(input_route.points.front().name);
+					const auto end   = m_network->index(input_route.points.back ().name);
+
+					const auto type = m_network->type(input_route.type);
+
+					const auto direction = m_network->direction(begin, end);
+
+					const auto [iterator, is_inserted] = distances.emplace(
+						std::make_tuple(end, type, direction), std::size(m_distances));
+
+					if (is_inserted)
+					{
+						m_distances.push_back((direction == Direction::error) ? 
+							Network::distances_container_t(std::size(m_network->segments()), Network::infinity) :
+							m_network->make_distances(end, type, direction));
+					}
+
+					const auto standard_time = ((direction == Direction::error) ? 0LL : 
+						m_network->segment(begin).standard_time(type, direction));
 
-					m_routes.push_back(std::make_pair(input_route.StartTime / seconds_in_minute,
-						Train(index++, input_route.type, get_direction(begin, end), begin, end, input_route.priority)));
+					m_routes.push_back(Route{ input_route.StartTime / seconds_in_minute, input_route.type, 
+						Train(index++, type, direction, begin, end, input_route.priority), standard_time, iterator->second });
 
 					if (!input_route.idPoints.empty())
 					{
@@ -144,15 +125,19 @@ namespace solution
 
 						m_time_begin /= seconds_in_minute;
 
-						m_head->trains.push_back(m_routes.back().second);
+						const auto position = std::size(m_origin.trains);
+
+						m_origin.trains.push_back(m_routes.back().train, standard_time);
 
-						m_head->trains.back().move(input_route.idPoints.back().name);
+						const auto segment = m_network->index(input_route.idPoints.back().name);
 
-						m_head->trains.back().set_segment_time(input_route.idPoints.back().dt / seconds_in_minute);
+						m_origin.trains.move(position, segment, m_network->segment(segment).standard_time(type, direction));
 
-						m_head->segments.at(input_route.idPoints.back().name).train_arrived();
+						m_origin.trains.set_segment_time(position, input_route.idPoints.back().dt / seconds_in_minute);
 
-						m_head->has_event = true;
+						m_origin.modify_occupancy().train_arrived(segment);
+
+						m_origin.has_event = true;
 					}
 				}
 
@@ -160,6 +145,17 @@ namespace solution
 				{
 					m_time_begin = *std::begin(starts);
 				}
+
+				for (auto i = 0U; i < std::size(input_routes); ++i)
+				{
+					if (input_routes[i].idPoints.empty())
+					{
+						m_schedule.push_back(i);
+					}
+				}
+
+				std::stable_sort(std::begin(m_schedule), std::end(m_schedule), 
+					[this](auto lhs, auto rhs) { return (m_routes[lhs].start < m_routes[rhs].start); });
 			}
 			catch (const std::exception & exception)
 			{
@@ -173,12 +169,49 @@ namespace solution
 
 			try
 			{
-				m_locks.reserve(std::size(input_locks));
+				m_locks.reserve(std::size(input_locks) * 2U);
 
 				for (const auto & input_lock : input_locks)
 				{
-					m_locks.push_back(Lock{ input_lock.name, 
-						input_lock.from / seconds_in_minute, input_lock.to / seconds_in_minute });
+					const auto segment = m_network->index(input_lock.name);
+
+					m_locks.push_back(Lock{ input_lock.from / seconds_in_minute, segment, true  });
+					m_locks.push_back(Lock{ input_lock.to   / seconds_in_minute, segment, false });
+				}
+
+				std::stable_sort(std::begin(m_locks), std::end(m_locks), 
+					[](const auto & lhs, const auto & rhs) { return (lhs.time < rhs.time); });
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// the charts of the previous solution are kept as the times at which
+		// each train leaves each of its segments, the first pass follows them
+		// and only the routes, which could not keep to them, are searched on
+
+		void System::make_plan(const plan_t & plan)
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				m_plan.assign(std::size(m_routes), departures_container_t());
+
+				m_affected_routes.assign(std::size(m_routes), true);
+
+				for (auto i = 0U; i < std::size(m_routes); ++i)
+				{
+					const auto iterator = plan.find(make_route_key(m_routes[i]));
+
+					if (iterator != std::end(plan))
+					{
+						m_plan[i] = make_departures(iterator->second);
+
+						m_affected_routes[i] = false;
+					}
 				}
 			}
 			catch (const std::exception & exception)
@@ -187,70 +220,168 @@ namespace solution
 			}
 		}
 
-		Direction System::get_direction(const std::string & begin, const std::string & end) const
+		// routes interact only if their footprints intersect: the segments,
+		// which they reach in their own direction and through which they can
+		// pass on the way to their ends, closed under the chains looked ahead
+		// by has_deadlock, the groups of interacting routes are solved as
+		// independent systems, which share the locks, the plan and the time
+		// window, and do not write the progress file
+
+		void System::make_regions(
+			const input_routes_t & input_routes,
+			const input_locks_t  & input_locks,
+			const plan_t & plan)
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				std::deque < std::pair < std::string, Direction > > segments;
+				const auto npos = std::numeric_limits < std::size_t > ::max();
 
-				segments.push_back(std::make_pair(begin, Direction::north));
-				segments.push_back(std::make_pair(begin, Direction::south));
+				std::vector < std::size_t > roots(std::size(m_routes));
 
-				std::unordered_set < std::string > visited_segments;
+				std::iota(std::begin(roots), std::end(roots), std::size_t(0U));
 
-				visited_segments.insert(begin);
+				auto find = [&roots](auto route)
+				{
+					for (; roots[route] != route; route = roots[route])
+					{
+						roots[route] = roots[roots[route]];
+					}
+
+					return route;
+				};
 
-				while (!segments.empty())
+				std::vector < std::size_t > owners(std::size(m_network->segments()), npos);
+
+				for (auto i = 0U; i < std::size(m_routes); ++i)
 				{
-					auto segment = segments.front();
+					const auto & train = m_routes[i].train;
+
+					if (train.direction == Direction::error)
+					{
+						continue;
+					}
+
+					const auto & distances = m_distances[m_routes[i].distances];
 
-					segments.pop_front();
+					std::vector < bool > footprint(std::size(owners), false);
 
-					switch (segment.second)
+					std::vector < std::size_t > segments;
+
+					auto insert = [&footprint, &segments](auto segment)
 					{
-					case Direction::north:
+						if (!footprint[segment])
+						{
+							footprint[segment] = true;
+
+							segments.push_back(segment);
+						}
+					};
+
+					std::vector < bool > is_reached(std::size(owners), false);
+
+					std::vector < std::size_t > reached(1U, train.begin);
+
+					is_reached[train.begin] = true;
+
+					for (auto j = 0U; j < std::size(reached); ++j)
 					{
-						for (const auto & next_segment : m_segments.at(segment.first).northern_adjacent_segments())
+						if (distances[reached[j]] != Network::infinity)
+						{
+							insert(reached[j]);
+						}
+
+						for (const auto segment : m_network->segment(reached[j]).adjacent_segments(train.direction))
 						{
-							if (visited_segments.find(next_segment) == std::end(visited_segments))
+							if (!is_reached[segment])
 							{
-								segments.push_back(std::make_pair(next_segment, Direction::north));
+								is_reached[segment] = true;
 
-								visited_segments.insert(next_segment);
+								reached.push_back(segment);
 							}
 						}
-
-						break;
 					}
-					case Direction::south:
+
+					for (auto j = 0U; j < std::size(segments); ++j)
 					{
-						for (const auto & next_segment : m_segments.at(segment.first).southern_adjacent_segments())
+						const auto & chain = m_network->chain(segments[j], train.direction);
+
+						for (const auto segment : chain.segments)
 						{
-							if (visited_segments.find(next_segment) == std::end(visited_segments))
-							{
-								segments.push_back(std::make_pair(next_segment, Direction::south));
+							insert(segment);
+						}
+
+						if (chain.end != Network::npos)
+						{
+							insert(chain.end);
 
-								visited_segments.insert(next_segment);
+							for (const auto segment : m_network->segment(chain.end).adjacent_segments(train.direction))
+							{
+								insert(segment);
 							}
 						}
-
-						break;
 					}
-					default:
+
+					for (auto segment : segments)
 					{
-						throw std::runtime_error("unknown direction");
-					}
+						if (owners[segment] == npos)
+						{
+							owners[segment] = i;
+						}
+						else
+						{
+							roots[find(i)] = find(owners[segment]);
+						}
 					}
+				}
+
+				std::map < std::size_t, std::size_t > indexes;
+
+				for (auto i = 0U; i < std::size(m_routes); ++i)
+				{
+					const auto [iterator, is_inserted] = indexes.emplace(find(i), std::size(m_regions_routes));
 
-					if (segment.first == end)
+					if (is_inserted)
 					{
-						return segment.second;
+						m_regions_routes.emplace_back();
 					}
+
+					m_regions_routes[iterator->second].push_back(i);
+				}
+
+				if (std::size(m_regions_routes) < 2U)
+				{
+					m_regions_routes.clear();
+
+					return;
 				}
 
-				return Direction::error;
+				auto settings = m_settings;
+
+				settings.has_regions = false;
+
+				settings.threads_limit = std::max(m_settings.threads_limit / std::size(m_regions_routes), std::size_t(1U));
+
+				for (const auto & routes : m_regions_routes)
+				{
+					input_routes_t region_routes;
+
+					region_routes.reserve(std::size(routes));
+
+					for (auto route : routes)
+					{
+						region_routes.push_back(input_routes[route]);
+					}
+
+					m_regions.push_back(std::make_unique < System > (m_network, region_routes, input_locks, settings, plan));
+
+					m_regions.back()->m_is_region = true;
+
+					m_regions.back()->m_time_begin = m_time_begin;
+
+					m_regions.back()->m_horizon_limit = m_horizon_limit;
+				}
 			}
 			catch (const std::exception & exception)
 			{
@@ -258,29 +389,13 @@ namespace solution
 			}
 		}
 
-		void System::clear(Node * node)
+		System::route_key_t System::make_route_key(const Route & route) const
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				if (node)
-				{
-					if (!node->children.empty())
-					{
-						for (auto child : node->children)
-						{
-							if (child)
-							{
-								clear(child);
-							}
-						}
-					}
-
-					delete node;
-
-					node = nullptr;
-				}
+				return std::make_tuple(route.start, route.type, route.train.begin, route.train.end);
 			}
 			catch (const std::exception & exception)
 			{
@@ -288,17 +403,24 @@ namespace solution
 			}
 		}
 
-		void System::run()
+		System::departures_container_t System::make_departures(const Chart & chart) const
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				make_tree();
+				departures_container_t departures;
 
-				make_charts();
+				auto time = chart.start;
 
-				m_done_flag.store(true);
+				for (const auto & point : chart.points)
+				{
+					time += point.time;
+
+					departures.emplace_back(m_network->index(point.segment), time);
+				}
+
+				return departures;
 			}
 			catch (const std::exception & exception)
 			{
@@ -306,40 +428,31 @@ namespace solution
 			}
 		}
 
-		void System::make_tree()
+		// marks the routes, whose published charts are not the tail of the
+		// planned ones, returns whether there is any such route
+
+		bool System::update_affected_routes()
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				std::fstream fout("progress.txt", std::ios::out);
+				auto has_affected_routes = false;
 
-				for (auto time = m_time_begin; (time - m_time_begin < time_limit) && 
-					(m_leafs.front()->completed_routes_counter < std::size(m_routes)); ++time)
+				for (auto i = 0U; i < std::size(m_routes); ++i)
 				{
-					auto leafs_copy = std::move(m_leafs);
-
-					m_leafs.clear();
+					const auto departures = make_departures(m_charts[i]);
 
-					for (auto i = 0U; i < std::size(leafs_copy); ++i)
+					if ((std::size(departures) > std::size(m_plan[i])) || departures.empty() ||
+						!std::equal(std::rbegin(departures), std::rend(departures), std::rbegin(m_plan[i])))
 					{
-						auto node = leafs_copy.front();
-
-						leafs_copy.pop_front();
-
-						make_trains(time, node);
-
-						update_segments(time, node);
-
-						execute_commands(node);
-
-						node->update_deviation();
-
-						make_new_nodes(node);
+						m_affected_routes[i] = true;
 					}
 
-					fout << time - m_time_begin << std::endl;
+					has_affected_routes = (has_affected_routes || m_affected_routes[i]);
 				}
+
+				return has_affected_routes;
 			}
 			catch (const std::exception & exception)
 			{
@@ -347,59 +460,52 @@ namespace solution
 			}
 		}
 
-		void System::make_charts()
+		System::plan_t System::plan() const
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				std::fstream fout("progress.txt", std::ios::out | std::ios::app);
-
-				std::vector < Node * > path;
-
-				std::sort(std::begin(m_leafs), std::end(m_leafs),
-					[](const auto & lhs, const auto & rhs) { return (lhs->deviation < rhs->deviation); });
+				std::scoped_lock lock(m_mutex);
 
-				path.push_back(m_leafs.front());
+				plan_t plan;
 
-				while (path.back()->parent)
+				for (auto i = 0U; i < std::size(m_charts); ++i)
 				{
-					path.push_back(path.back()->parent);
+					if (!m_charts[i].points.empty())
+					{
+						plan.emplace(make_route_key(m_routes[i]), m_charts[i]);
+					}
 				}
 
-				fout << "length: " << std::size(path) << std::endl;
+				return plan;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
 
-				std::reverse(std::begin(path), std::end(path));
+		void System::make_head()
+		{
+			RUN_LOGGER(logger);
 
-				auto delta = 0LL;
+			try
+			{
+				m_leafs.clear();
 
-				m_charts.resize(std::size(m_routes));
+				m_nodes.clear();
 
-				for (const auto node : path)
-				{
-					for (const auto & train : node->trains)
-					{
-						if (m_charts[train.index].points.empty())
-						{
-							m_charts[train.index].start    = m_time_begin + delta;
-							m_charts[train.index].type     = train.type;
-							m_charts[train.index].priority = train.priority;
+				m_head = m_nodes.create();
 
-							m_charts[train.index].points.push_back(Point{ train.segment(), 0LL });
-						}
+				m_head->occupancy = m_origin.occupancy;
+				m_head->has_shared_occupancy = true;
+				m_head->trains = m_origin.trains;
+				m_head->has_event = m_origin.has_event;
 
-						if (m_charts[train.index].points.back().segment == train.segment())
-						{
-							++m_charts[train.index].points.back().time;
-						}
-						else
-						{
-							m_charts[train.index].points.push_back(Point{ train.segment(), 1LL });
-						}
-					}
+				m_leafs.push_back(m_head);
 
-					++delta;
-				}
+				m_has_truncated_frontier.store(false);
 			}
 			catch (const std::exception & exception)
 			{
@@ -407,7 +513,7 @@ namespace solution
 			}
 		}
 
-		void System::cut_tree(Node * node, const std::set < Node * > & required_nodes)
+		void System::clear(Node * node)
 		{
 			RUN_LOGGER(logger);
 
@@ -415,25 +521,21 @@ namespace solution
 			{
 				if (node)
 				{
-					if (required_nodes.find(node) == std::end(required_nodes))
+					for (auto child : node->children)
 					{
-						clear(node);
+						child->parent = nullptr;
+
+						clear(child);
 					}
-					else
-					{
-						for (auto child : node->children)
-						{
-							if (child)
-							{
-								cut_tree(child, required_nodes);
-							}
-						}
 
-						node->children.erase(std::remove_if(std::begin(node->children), std::end(node->children),
-							[](const auto child) { return (child == nullptr); }), std::end(node->children));
+					if (node->parent)
+					{
+						auto & children = node->parent->children;
 
-						node->children.shrink_to_fit();
+						children.erase(std::remove(std::begin(children), std::end(children), node), std::end(children));
 					}
+
+					m_nodes.destroy(node);
 				}
 			}
 			catch (const std::exception & exception)
@@ -442,24 +544,19 @@ namespace solution
 			}
 		}
 
-		void System::make_trains(std::time_t time, Node * node) const
+		void System::cut_branch(Node * node)
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				for (const auto & route : m_routes)
+				while (node && node->parent && node->children.empty())
 				{
-					const auto begin = route.second.begin;
-
-					if (route.first == time && node->segments.at(begin).is_available())
-					{
-						node->trains.push_back(route.second);
+					auto parent = node->parent;
 
-						node->segments.at(begin).train_arrived();
+					clear(node);
 
-						node->has_event = true;
-					}
+					node = parent;
 				}
 			}
 			catch (const std::exception & exception)
@@ -468,28 +565,82 @@ namespace solution
 			}
 		}
 
-		void System::update_segments(std::time_t time, Node * node) const
+		void System::run()
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				for (const auto & lock : m_locks)
+				if (m_settings.time_limit > 0.0)
+				{
+					m_deadline = std::chrono::steady_clock::now() + 
+						std::chrono::duration_cast < std::chrono::steady_clock::duration > (
+							std::chrono::duration < double > (m_settings.time_limit));
+				}
+
+				if (!m_regions.empty())
+				{
+					run_regions();
+
+					m_done_flag.store(true);
+
+					return;
+				}
+
+				if (std::any_of(std::begin(m_plan), std::end(m_plan), [](const auto & departures) { return !departures.empty(); }))
 				{
-					if (time == lock.begin)
+					m_strategies_limit = 1U;
+
+					m_branches_limit = 0U;
+
+					make_head();
+
+					if (make_tree())
+					{
+						make_charts();
+					}
+
+					if (!m_charts.empty() && !update_affected_routes())
 					{
-						node->segments.at(lock.segment).state = Segment::State::locked;
+						m_done_flag.store(true);
 
-						node->has_event = true;
+						return;
 					}
+				}
 
-					if (time == lock.end)
+				if (m_settings.rollouts_limit > 0U)
+				{
+					search();
+				}
+				else
+				{
+					for (auto strategies = m_settings.strategies_initial; ; 
+						strategies = std::min(strategies * m_settings.strategies_factor, m_settings.strategies_limit))
 					{
-						node->segments.at(lock.segment).state = Segment::State::normal;
+						m_strategies_limit = strategies;
+
+						m_branches_limit = m_settings.branches_limit;
+
+						make_head();
+
+						if (make_tree())
+						{
+							make_charts();
+						}
 
-						node->has_event = true;
+						if ((strategies >= m_settings.strategies_limit) || !m_has_truncated_frontier.load() || has_expired())
+						{
+							break;
+						}
 					}
 				}
+
+				if ((m_settings.neighbourhoods_limit > 0U) && !m_charts.empty())
+				{
+					improve();
+				}
+
+				m_done_flag.store(true);
 			}
 			catch (const std::exception & exception)
 			{
@@ -497,35 +648,1271 @@ namespace solution
 			}
 		}
 
-		void System::execute_commands(Node * node) const
+		// the regions are solved in parallel, each with its share of threads,
+		// and their charts are stitched in the order of the input routes
+
+		void System::run_regions()
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				std::for_each(std::begin(node->trains), std::end(node->trains),
+				{
+					boost::asio::thread_pool pool(std::min(m_settings.threads_limit, std::size(m_regions)));
+
+					std::vector < std::future < void > > futures;
+
+					for (auto & region : m_regions)
+					{
+						auto task = std::make_shared < std::packaged_task < void() > > (
+							[&region]() { region->run(); });
+
+						futures.push_back(task->get_future());
+
+						boost::asio::post(pool, [task]() { (*task)(); });
+					}
+
+					pool.join();
+
+					for (auto & future : futures)
+					{
+						future.get();
+					}
+				}
+
+				charts_container_t charts(std::size(m_routes));
+
+				std::pair < std::size_t, double > quality(0U, 0.0);
+
+				for (auto i = 0U; i < std::size(m_regions); ++i)
+				{
+					const auto & region = m_regions[i];
+
+					const auto & routes = m_regions_routes[i];
+
+					if (region->m_charts.empty())
+					{
+						quality.first += std::size(routes);
+
+						continue;
+					}
+
+					for (auto j = 0U; j < std::size(routes); ++j)
+					{
+						charts[routes[j]] = region->m_charts[j];
+					}
+
+					quality.first  += region->m_charts_quality.first;
+					quality.second += region->m_charts_quality.second;
+				}
+
+				std::scoped_lock lock(m_mutex);
+
+				m_charts = charts;
+
+				m_variants.assign(1U, std::move(charts));
+
+				m_variants_qualities.assign(1U, quality);
+
+				m_charts_quality = quality;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// monte carlo tree search: each rollout descends the tree of decisions
+		// by the upper confidence bound, adds one decision and completes the
+		// routes with random decisions, the rewards are the deviations scaled
+		// between the best and the worst ones among the rollouts, which have
+		// completed the most routes, the rollouts run in parallel threads after
+		// the greedy one, so that charts are published even without time
+
+		void System::search()
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				const auto npos = std::numeric_limits < std::size_t > ::max();
+
+				m_strategies_limit = 1U;
+
+				m_branches_limit = m_settings.branches_limit;
+
+				decisions_container_t decisions(1U);
+
+				std::mutex mutex;
+
+				std::atomic < std::size_t > counter = 0U;
+
+				std::vector < std::size_t > best_masks;
+
+				auto best_quality = simulate([&best_masks](std::size_t) { best_masks.push_back(0U); return 0U; }, nullptr);
+
+				auto best_deviations = std::make_pair(best_quality.second, best_quality.second);
+
+				auto rollout = [&](std::size_t seed)
+				{
+					std::mt19937 engine(static_cast < std::mt19937::result_type > (seed));
+
+					std::bernoulli_distribution is_waiting(waiting_probability);
+
+					while ((counter++ < m_settings.rollouts_limit) && !has_expired())
+					{
+						std::vector < std::size_t > path(1U, 0U);
+
+						std::vector < std::size_t > masks;
+
+						auto is_in_tree = true;
+
+						{
+							std::scoped_lock lock(mutex);
+
+							++decisions.front().visits;
+						}
+
+						auto choose = [&](std::size_t size)
+						{
+							std::size_t mask = 0U;
+
+							if (is_in_tree)
+							{
+								std::scoped_lock lock(mutex);
+
+								auto & children = decisions[path.back()].children;
+
+								if (children.empty())
+								{
+									children.assign(size, npos);
+								}
+
+								if (const auto iterator = std::find(std::begin(children), std::end(children), npos);
+									iterator != std::end(children))
+								{
+									mask = std::distance(std::begin(children), iterator);
+
+									*iterator = std::size(decisions);
+
+									decisions.emplace_back();
+
+									is_in_tree = false;
+								}
+								else
+								{
+									const auto visits = static_cast < double > (decisions[path.back()].visits);
+
+									auto bound = -std::numeric_limits < double > ::infinity();
+
+									for (auto i = 0U; i < std::size(children); ++i)
+									{
+										const auto & child = decisions[children[i]];
+
+										const auto child_bound = child.value / child.visits + 
+											exploration * std::sqrt(std::log(visits) / child.visits);
+
+										if (child_bound > bound)
+										{
+											bound = child_bound;
+
+											mask = i;
+										}
+									}
+								}
+
+								path.push_back(decisions[path.back()].children[mask]);
+
+								++decisions[path.back()].visits;
+							}
+							else
+							{
+								for (auto i = 0U; (std::size_t(1U) << i) < size; ++i)
+								{
+									if (is_waiting(engine))
+									{
+										mask |= (std::size_t(1U) << i);
+									}
+								}
+							}
+
+							masks.push_back(mask);
+
+							return mask;
+						};
+
+						const auto quality = simulate(choose, nullptr);
+
+						std::scoped_lock lock(mutex);
+
+						if (quality.first < best_quality.first)
+						{
+							best_deviations = std::make_pair(quality.second, quality.second);
+						}
+
+						if (quality.first <= best_quality.first)
+						{
+							best_deviations.first  = std::min(best_deviations.first,  quality.second);
+							best_deviations.second = std::max(best_deviations.second, quality.second);
+						}
+
+						if (quality < best_quality)
+						{
+							best_quality = quality;
+
+							best_masks = masks;
+						}
+
+						auto reward = 0.0;
+
+						if (quality.first == best_quality.first)
+						{
+							reward = ((best_deviations.second > best_deviations.first) ? 
+								(best_deviations.second - quality.second) / (best_deviations.second - best_deviations.first) : 1.0);
+						}
+
+						for (auto decision : path)
+						{
+							decisions[decision].value += reward;
+						}
+					}
+				};
+
+				std::unique_ptr < boost::asio::thread_pool > pool;
+
+				std::vector < std::future < void > > futures;
+
+				if (m_settings.threads_limit > 1U)
+				{
+					pool = std::make_unique < boost::asio::thread_pool > (m_settings.threads_limit - 1U);
+
+					for (auto i = 1U; i < m_settings.threads_limit; ++i)
+					{
+						auto task = std::make_shared < std::packaged_task < void() > > (
+							[&rollout, i]() { rollout(i); });
+
+						futures.push_back(task->get_future());
+
+						boost::asio::post(*pool, [task]() { (*task)(); });
+					}
+				}
+
+				try
+				{
+					rollout(0U);
+				}
+				catch (...)
+				{
+					for (const auto & future : futures)
+					{
+						future.wait();
+					}
+
+					throw;
+				}
+
+				for (const auto & future : futures)
+				{
+					future.wait();
+				}
+
+				for (auto & future : futures)
+				{
+					future.get();
+				}
+
+				charts_container_t charts(std::size(m_routes));
+
+				auto position = 0U;
+
+				simulate([&best_masks, &position](std::size_t) { return best_masks[position++]; }, &charts);
+
+				if (!m_charts.empty() && !m_has_partial_charts && !(best_quality < m_charts_quality))
+				{
+					return;
+				}
+
+				std::scoped_lock lock(m_mutex);
+
+				m_charts = charts;
+
+				m_variants.assign(1U, std::move(charts));
+
+				m_variants_qualities.assign(1U, best_quality);
+
+				m_charts_quality = best_quality;
+
+				m_has_partial_charts = false;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// one run of the transition model from the origin, where the commands
+		// of the branching trains are given by the masks, which are chosen,
+		// returns the number of routes not completed and the deviation
+
+		std::pair < std::size_t, double > System::simulate(
+			const std::function < std::size_t(std::size_t) > & choose, charts_container_t * charts) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				Node state;
+
+				state.occupancy = m_origin.occupancy;
+				state.has_shared_occupancy = true;
+				state.trains = m_origin.trains;
+				state.has_event = m_origin.has_event;
+
+				auto last_time = m_time_begin - 1LL;
+
+				for (auto time = m_time_begin; (time - m_time_begin < m_horizon_limit) && 
+					(state.completed_routes_counter < std::size(m_routes)); ++time)
+				{
+					const auto duration = get_quiet_duration(&state, 
+						std::min < std::time_t > (get_next_event(time), m_time_begin + m_horizon_limit - 1LL) - time);
+
+					if (duration > 0LL)
+					{
+						advance(&state, duration);
+
+						time += duration;
+					}
+
+					state.time = time;
+
+					make_trains(time, &state);
+
+					update_segments(time, &state);
+
+					execute_commands(&state);
+
+					if (charts)
+					{
+						record(&state, last_time, *charts);
+					}
+
+					last_time = time;
+
+					make_commands(&state);
+
+					if (!state.branches.empty())
+					{
+						const auto mask = choose(std::size_t(1U) << std::size(state.branches));
+
+						for (auto i = 0U; i < std::size(state.branches); ++i)
+						{
+							state.trains[state.branches[i]].command = state.command(state.branches[i], mask);
+						}
+					}
+
+					state.has_event = false;
+				}
+
+				return std::make_pair(std::size(m_routes) - state.completed_routes_counter, state.deviation);
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// large neighbourhood search over the published charts: the trains of
+		// a small neighbourhood are released, the others keep to their charts
+		// as to a plan, and the pass with the wider beam is published only if
+		// it improves the quality, until the limit or the deadline is reached
+
+		void System::improve()
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				std::mt19937 engine;
+
+				for (auto i = 0U; (i < m_settings.neighbourhoods_limit) && !has_expired(); ++i)
+				{
+					const auto neighbourhood = make_neighbourhood(engine);
+
+					if (neighbourhood.empty())
+					{
+						break;
+					}
+
+					for (auto j = 0U; j < std::size(m_routes); ++j)
+					{
+						m_plan[j] = make_departures(m_charts[j]);
+
+						m_affected_routes[j] = m_plan[j].empty();
+					}
+
+					for (auto route : neighbourhood)
+					{
+						m_affected_routes[route] = true;
+					}
+
+					m_strategies_limit = m_settings.neighbourhood_strategies;
+
+					m_branches_limit = m_settings.branches_limit;
+
+					make_head();
+
+					if (make_tree())
+					{
+						make_charts();
+					}
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// the seed route is drawn in proportion to its deviation, it is joined
+		// by the routes nearest to it in start time, which share a segment
+
+		std::vector < std::size_t > System::make_neighbourhood(std::mt19937 & engine) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				std::vector < double > deviations(std::size(m_routes), 0.0);
+
+				std::vector < std::set < std::string > > segments(std::size(m_routes));
+
+				for (auto i = 0U; i < std::size(m_routes); ++i)
+				{
+					const auto & train = m_routes[i].train;
+
+					for (const auto & point : m_charts[i].points)
+					{
+						const auto standard_time = m_network->segment(
+							m_network->index(point.segment)).standard_time(train.type, train.direction);
+
+						deviations[i] += train.priority * static_cast < double > (
+							std::max < std::time_t > (point.time - standard_time, 0LL));
+
+						segments[i].insert(point.segment);
+					}
+				}
+
+				if (std::all_of(std::begin(deviations), std::end(deviations), [](auto deviation) { return (deviation <= 0.0); }))
+				{
+					return {};
+				}
+
+				const auto seed = std::discrete_distribution < std::size_t > (
+					std::begin(deviations), std::end(deviations))(engine);
+
+				std::vector < std::pair < std::time_t, std::size_t > > neighbours;
+
+				for (auto i = 0U; i < std::size(m_routes); ++i)
+				{
+					if ((i != seed) && std::any_of(std::begin(segments[i]), std::end(segments[i]),
+						[&segments, seed](const auto & segment) { return (segments[seed].count(segment) > 0U); }))
+					{
+						neighbours.emplace_back(std::abs(m_charts[i].start - m_charts[seed].start), i);
+					}
+				}
+
+				const auto size = std::min(m_settings.neighbourhood_size - 1U, std::size(neighbours));
+
+				std::partial_sort(std::begin(neighbours), std::next(std::begin(neighbours), size), std::end(neighbours));
+
+				std::vector < std::size_t > neighbourhood(1U, seed);
+
+				for (auto i = 0U; i < size; ++i)
+				{
+					neighbourhood.push_back(neighbours[i].second);
+				}
+
+				return neighbourhood;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// at the deadline the pass is abandoned if some charts are already
+		// published, otherwise it is finished greedily with a single node
+		// and no branching, so that there is a complete result anyway
+
+		bool System::make_tree()
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				std::fstream fout;
+
+				if (!m_is_region)
+				{
+					fout.open("progress.txt", std::ios::out);
+				}
+
+				const auto threads_limit = m_settings.threads_limit;
+
+				std::unique_ptr < boost::asio::thread_pool > pool;
+
+				if (threads_limit > 1U)
+				{
+					pool = std::make_unique < boost::asio::thread_pool > (threads_limit - 1U);
+				}
+
+				const auto quality_limit = ((m_has_partial_charts || (std::size(m_variants) < m_settings.variants_limit)) ? 
+					std::make_pair(std::numeric_limits < std::size_t > ::max(), 0.0) : m_variants_qualities.back());
+
+				const auto window = static_cast < std::time_t > (m_settings.horizon_window);
+
+				const auto step = std::min < std::time_t > (static_cast < std::time_t > (m_settings.horizon_step), window);
+
+				auto commit_time = m_time_begin;
+
+				for (auto time = m_time_begin; (time - m_time_begin < m_horizon_limit) && !m_leafs.empty() &&
+					!has_completed_variants(); ++time)
+				{
+					if (has_expired())
+					{
+						if (!m_charts.empty() && !m_has_partial_charts)
+						{
+							return false;
+						}
+
+						m_strategies_limit = 1U;
+
+						m_branches_limit = 0U;
+					}
+
+					const auto duration = get_quiet_duration(time);
+
+					time += duration;
+
+					auto leafs_copy = std::move(m_leafs);
+
+					m_leafs.clear();
+
+					std::vector < children_container_t > children(threads_limit);
+
+					std::atomic < std::size_t > position = 0U;
+
+					auto expand = [this, time, duration, quality_limit, &leafs_copy, &position](children_container_t & buffer)
+					{
+						for (auto index = position++; index < std::size(leafs_copy); index = position++)
+						{
+							auto node = leafs_copy[index];
+
+							if (duration > 0LL)
+							{
+								advance(node, duration);
+							}
+
+							node->time = time;
+
+							make_trains(time, node);
+
+							update_segments(time, node);
+
+							execute_commands(node);
+
+							node->lost_routes = get_lost_routes(time, node);
+
+							if (!(std::make_pair(node->lost_routes, node->deviation) < quality_limit))
+							{
+								continue;
+							}
+
+							make_new_nodes(node, index, buffer);
+						}
+					};
+
+					std::vector < std::future < void > > futures;
+
+					for (auto i = 1U; i < std::min(threads_limit, std::size(leafs_copy)); ++i)
+					{
+						auto task = std::make_shared < std::packaged_task < void() > > (
+							[&expand, &buffer = children[i]]() { expand(buffer); });
+
+						futures.push_back(task->get_future());
+
+						boost::asio::post(*pool, [task]() { (*task)(); });
+					}
+
+					try
+					{
+						expand(children.front());
+					}
+					catch (...)
+					{
+						for (const auto & future : futures)
+						{
+							future.wait();
+						}
+
+						throw;
+					}
+
+					for (const auto & future : futures)
+					{
+						future.wait();
+					}
+
+					for (auto & future : futures)
+					{
+						future.get();
+					}
+
+					make_leafs(leafs_copy, children);
+
+					for (auto node : leafs_copy)
+					{
+						cut_branch(node);
+					}
+
+					if ((window > 0LL) && (time - commit_time >= window))
+					{
+						commit_time = time - window + step;
+
+						commit(commit_time);
+					}
+
+					fout << time - m_time_begin << std::endl;
+				}
+
+				return true;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// the published variants and the best leafs are merged in order of
+		// quality, a leaf is replayed only when its turn comes, and becomes a
+		// variant if it completes all the routes and its trains wait at other
+		// times than in every variant taken before for at least the given
+		// number of trains
+
+		void System::make_charts()
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (m_leafs.empty())
+				{
+					return;
+				}
+
+				std::sort(std::begin(m_leafs), std::end(m_leafs),
+					[](const auto & lhs, const auto & rhs)
+					{
+						return (std::make_pair(rhs->completed_routes_counter, lhs->deviation) <
+							std::make_pair(lhs->completed_routes_counter, rhs->deviation));
+					});
+
+				auto get_quality = [this](const auto leaf)
+				{
+					return std::make_pair(std::size(m_routes) - leaf->completed_routes_counter, leaf->deviation);
+				};
+
+				auto is_different = [this](const auto & lhs, const auto & rhs)
+				{
+					auto counter = 0U;
+
+					for (auto i = 0U; i < std::size(lhs); ++i)
+					{
+						if (lhs[i].waits != rhs[i].waits)
+						{
+							++counter;
+						}
+					}
+
+					return (counter >= m_settings.variants_difference);
+				};
+
+				std::vector < charts_container_t > variants;
+
+				std::vector < std::pair < std::size_t, double > > qualities;
+
+				const auto size = (m_has_partial_charts ? 0U : std::size(m_variants));
+
+				auto leaf = std::begin(m_leafs);
+
+				for (auto index = 0U; (std::size(variants) < m_settings.variants_limit) && 
+					((index < size) || (leaf != std::end(m_leafs))); )
+				{
+					const auto is_published = ((leaf == std::end(m_leafs)) || 
+						((index < size) && !(get_quality(*leaf) < m_variants_qualities[index])));
+
+					const auto quality = (is_published ? m_variants_qualities[index] : get_quality(*leaf));
+
+					auto charts = (is_published ? m_variants[index++] : replay(*leaf++));
+
+					if (variants.empty() || ((quality.first == 0U) && std::all_of(std::begin(variants), std::end(variants), 
+						[&is_different, &charts](const auto & variant) { return is_different(variant, charts); })))
+					{
+						variants.push_back(std::move(charts));
+
+						qualities.push_back(quality);
+					}
+				}
+
+				std::scoped_lock lock(m_mutex);
+
+				m_charts = variants.front();
+
+				m_variants = std::move(variants);
+
+				m_variants_qualities = std::move(qualities);
+
+				m_charts_quality = m_variants_qualities.front();
+
+				m_has_partial_charts = false;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// rolling horizon: the best leaf fixes its path up to the given time,
+		// the leafs branched off this path before are cut, and the fixed part
+		// is published as partial charts until the first complete ones
+
+		void System::commit(std::time_t time)
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (m_leafs.empty())
+				{
+					return;
+				}
+
+				auto get_anchor = [time](const Node * leaf)
+				{
+					auto child = leaf;
+
+					auto node = leaf->parent;
+
+					for (; node && (node->time > time); node = node->parent)
+					{
+						child = node;
+					}
+
+					return std::make_pair(node, child);
+				};
+
+				const auto [anchor, child] = get_anchor(m_leafs.front());
+
+				if (!anchor)
+				{
+					return;
+				}
+
+				leafs_container_t leafs;
+
+				for (auto leaf : m_leafs)
+				{
+					if (get_anchor(leaf).first == anchor)
+					{
+						leafs.push_back(leaf);
+					}
+					else
+					{
+						cut_branch(leaf);
+					}
+				}
+
+				m_leafs = std::move(leafs);
+
+				if (m_charts.empty() || m_has_partial_charts)
+				{
+					auto charts = replay(child);
+
+					std::scoped_lock lock(m_mutex);
+
+					m_charts = charts;
+
+					m_variants.assign(1U, std::move(charts));
+
+					m_has_partial_charts = true;
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		System::charts_container_t System::replay(const Node * leaf) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				std::fstream fout;
+
+				if (!m_is_region)
+				{
+					fout.open("progress.txt", std::ios::out | std::ios::app);
+				}
+
+				std::vector < const Node * > path;
+
+				for (auto node = leaf->parent; node; node = node->parent)
+				{
+					path.push_back(node);
+				}
+
+				fout << "length: " << std::size(path) << std::endl;
+
+				std::reverse(std::begin(path), std::end(path));
+
+				auto last_time = m_time_begin - 1LL;
+
+				charts_container_t charts(std::size(m_routes));
+
+				Node state;
+
+				state.occupancy = m_origin.occupancy;
+				state.has_shared_occupancy = true;
+				state.trains = m_origin.trains;
+
+				for (const auto node : path)
+				{
+					for (auto i = 0U; i < std::size(node->commands); ++i)
+					{
+						state.trains[i].command = node->commands[i];
+					}
+
+					if (const auto duration = node->time - last_time - 1LL; duration > 0LL)
+					{
+						advance(&state, duration);
+					}
+
+					state.time = node->time;
+
+					make_trains(state.time, &state);
+
+					update_segments(state.time, &state);
+
+					execute_commands(&state);
+
+					record(&state, last_time, charts);
+
+					last_time = state.time;
+				}
+
+				return charts;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// the time spent by each train since the last processed time is added
+		// to the charts, a new point is started for a new segment, the times
+		// of the waits are kept to tell the variants apart
+
+		void System::record(const Node * state, std::time_t last_time, charts_container_t & charts) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				for (auto position = 0U; position < std::size(state->trains); ++position)
+				{
+					const auto & train = state->trains[position];
+
+					const auto & segment = m_network->segment(train.segment()).name;
+
+					const auto duration = std::min < std::time_t > (state->time - last_time, state->trains.segment_time(position));
+
+					if (charts[train.index].points.empty())
+					{
+						charts[train.index].start    = state->time - duration + 1LL;
+						charts[train.index].type     = m_routes[train.index].type;
+						charts[train.index].priority = train.priority;
+
+						charts[train.index].points.push_back(Point{ segment, 0LL });
+					}
+
+					if (charts[train.index].points.back().segment == segment)
+					{
+						charts[train.index].points.back().time += duration;
+					}
+					else
+					{
+						charts[train.index].points.push_back(Point{ segment, duration });
+					}
+
+					if (train.command == Train::Command::wait)
+					{
+						charts[train.index].waits.push_back(state->time);
+					}
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// the search goes on until the best leaf has completed all the routes
+		// and each of the other leafs, which are to become variants, has either
+		// completed them too or lost some of them
+
+		bool System::has_completed_variants() const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (m_leafs.front()->completed_routes_counter < std::size(m_routes))
+				{
+					return false;
+				}
+
+				const auto size = std::min(m_settings.variants_limit, std::size(m_leafs));
+
+				return std::all_of(std::begin(m_leafs), std::next(std::begin(m_leafs), size), 
+					[this](const auto leaf)
+					{
+						return ((leaf->completed_routes_counter == std::size(m_routes)) || (leaf->lost_routes > 0U));
+					});
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::cut_tree(Node * node, const std::set < Node * > & required_nodes)
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (node)
+				{
+					if (required_nodes.find(node) == std::end(required_nodes))
+					{
+						clear(node);
+					}
+					else
+					{
+						const auto children = node->children;
+
+						for (auto child : children)
+						{
+							cut_tree(child, required_nodes);
+						}
+
+						node->children.shrink_to_fit();
+					}
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		std::time_t System::get_next_event(std::time_t time) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				auto next_event = m_time_begin + m_horizon_limit;
+
+				const auto route = std::lower_bound(std::begin(m_schedule), std::end(m_schedule), time,
+					[this](auto index, auto time) { return (m_routes[index].start < time); });
+
+				if (route != std::end(m_schedule))
+				{
+					next_event = std::min(next_event, m_routes[*route].start);
+				}
+
+				const auto lock = std::lower_bound(std::begin(m_locks), std::end(m_locks), time,
+					[](const auto & lock, auto time) { return (lock.time < time); });
+
+				if (lock != std::end(m_locks))
+				{
+					next_event = std::min(next_event, lock->time);
+				}
+
+				return next_event;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// number of ticks from time on, which change nothing but the segment
+		// times and deviations of the trains in all leafs, the tick at which
+		// some train becomes ready or some route or lock event occurs is not
+		// included, so that it is processed as usual
+
+		std::time_t System::get_quiet_duration(std::time_t time) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				auto duration = std::min < std::time_t > (get_next_event(time), m_time_begin + m_horizon_limit - 1LL) - time;
+
+				for (const auto node : m_leafs)
+				{
+					duration = get_quiet_duration(node, duration);
+
+					if (duration <= 0LL)
+					{
+						return 0LL;
+					}
+				}
+
+				return std::max < std::time_t > (duration, 0LL);
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		std::time_t System::get_quiet_duration(const Node * node, std::time_t duration) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				for (auto route : node->pending_routes)
+				{
+					if (node->occupancy->is_available(m_routes[route].train.begin))
+					{
+						return 0LL;
+					}
+				}
+
+				for (auto position = 0U; position < std::size(node->trains); ++position)
+				{
+					if (duration <= 0LL)
+					{
+						return 0LL;
+					}
+
+					switch (node->trains[position].command)
+					{
+					case Train::Command::stay:
+					{
+						duration = std::min < std::time_t > (duration, 
+							node->trains.standard_time(position) - node->trains.segment_time(position) - 1LL);
+
+						break;
+					}
+					default:
+					{
+						return 0LL;
+					}
+					}
+				}
+
+				return std::max < std::time_t > (duration, 0LL);
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::advance(Node * node, std::time_t duration) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				node->deviation += node->trains.stay(duration);
+
+				for (auto route : node->pending_routes)
+				{
+					node->deviation += m_routes[route].train.priority * static_cast < double > (duration);
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// lower bound of the number of routes of the node, which can not be
+		// completed within the time limit even if the trains are never held
+
+		std::size_t System::get_lost_routes(std::time_t time, const Node * node) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				const auto time_end = m_time_begin + m_horizon_limit - 1LL;
+
+				auto lost_routes = 0U;
+
+				auto is_lost = [this, time, time_end](std::size_t index, std::size_t segment, std::time_t remaining_time)
+				{
+					const auto distance = m_distances[m_routes[index].distances][segment];
+
+					return ((distance == Network::infinity) || (time + remaining_time + distance + 1LL > time_end));
+				};
+
+				for (auto position = 0U; position < std::size(node->trains); ++position)
+				{
+					const auto & train = node->trains[position];
+
+					if (is_lost(train.index, train.segment(), std::max < std::time_t > (
+						node->trains.standard_time(position) - node->trains.segment_time(position), 0LL)))
+					{
+						++lost_routes;
+					}
+				}
+
+				for (auto route : node->pending_routes)
+				{
+					if (is_lost(route, m_routes[route].train.begin, m_routes[route].standard_time))
+					{
+						++lost_routes;
+					}
+				}
+
+				return lost_routes;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::make_trains(std::time_t time, Node * node) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				auto release = [this, node](std::size_t index)
+				{
+					const auto & train = m_routes[index].train;
+
+					if (!node->occupancy->is_available(train.begin))
+					{
+						return false;
+					}
+
+					const auto position = std::upper_bound(std::begin(node->trains), std::end(node->trains), train,
+						[](const auto & lhs, const auto & rhs) { return (lhs.index < rhs.index); });
+
+					node->trains.insert(std::distance(std::begin(node->trains), position), train, m_routes[index].standard_time);
+
+					node->modify_occupancy().train_arrived(train.begin);
+
+					node->has_event = true;
+
+					return true;
+				};
+
+				const auto pending_routes = std::move(node->pending_routes);
+
+				node->pending_routes.clear();
+
+				for (auto route : pending_routes)
+				{
+					if (!release(route))
+					{
+						node->pending_routes.push_back(route);
+					}
+				}
+
+				for (auto route = std::lower_bound(std::begin(m_schedule), std::end(m_schedule), time,
+					[this](auto index, auto time) { return (m_routes[index].start < time); });
+					(route != std::end(m_schedule)) && (m_routes[*route].start == time); ++route)
+				{
+					if (!release(*route))
+					{
+						node->pending_routes.push_back(*route);
+					}
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::update_segments(std::time_t time, Node * node) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				for (auto lock = std::lower_bound(std::begin(m_locks), std::end(m_locks), time,
+					[](const auto & lock, auto time) { return (lock.time < time); }); 
+					(lock != std::end(m_locks)) && (lock->time == time); ++lock)
+				{
+					if (lock->is_locked)
+					{
+						node->modify_occupancy().lock(lock->segment);
+					}
+					else
+					{
+						node->modify_occupancy().unlock(lock->segment);
+					}
+
+					node->has_event = true;
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::execute_commands(Node * node) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				std::for_each(std::begin(node->trains), std::end(node->trains),
 					[this, node](const auto & train) 
 					{
 						if (train.command == Train::Command::skip)
 						{
-							node->segments.at(train.segment()).train_departured();
+							node->modify_occupancy().train_departured(train.segment());
 
 							++node->completed_routes_counter;
 						}
 					});
 
-				node->trains.erase(std::remove_if(std::begin(node->trains), std::end(node->trains), 
-					[](const auto & train) { return (train.command == Train::Command::skip); }), std::end(node->trains));
+				node->trains.erase_if([](const auto & train) { return (train.command == Train::Command::skip); });
 
-				for (auto & train : node->trains)
+				for (auto position = 0U; position < std::size(node->trains); ++position)
 				{
+					const auto & train = node->trains[position];
+
 					switch (train.command)
 					{
 					case Train::Command::stay:
 					case Train::Command::wait:
 					{
-						train.stay(node->segments.at(train.segment()).standard_time(train.type, train.direction));
-
 						break;
 					}
 					case Train::Command::move:
@@ -536,28 +1923,27 @@ namespace solution
 							{
 							case Direction::north:
 							{
-								const auto & segments = node->segments.at(train.segment()).northern_adjacent_segments();
+								const auto & segments = m_network->segment(train.segment()).northern_adjacent_segments();
 
 								bool has_end = (std::find(std::begin(segments), std::end(segments), train.end) != std::end(segments));
 
 								for (const auto & segment : segments)
-								{
-									if (node->segments.at(segment).is_available() && !has_deadlock(node, train.segment(), train.direction))
-									{
-										node->segments.at(train.segment()).train_departured();
-
-										if (has_end)
-										{
-											train.move(train.end);
-										}
-										else
+								{
+									if (node->occupancy->is_available(segment))
+									{
+										if (!has_deadlock(node, train.segment(), train.direction))
 										{
-											train.move(segment);
-										}
+											node->modify_occupancy().train_departured(train.segment());
+
+											const auto next_segment = (has_end ? train.end : segment);
 
-										node->segments.at(train.segment()).train_arrived();
+											node->trains.move(position, next_segment, 
+												m_network->segment(next_segment).standard_time(train.type, train.direction));
 
-										node->has_event = true;
+											node->modify_occupancy().train_arrived(train.segment());
+
+											node->has_event = true;
+										}
 
 										break;
 									}
@@ -567,28 +1953,27 @@ namespace solution
 							}
 							case Direction::south:
 							{
-								const auto & segments = node->segments.at(train.segment()).southern_adjacent_segments();
+								const auto & segments = m_network->segment(train.segment()).southern_adjacent_segments();
 
 								bool has_end = (std::find(std::begin(segments), std::end(segments), train.end) != std::end(segments));
 
 								for (const auto & segment : segments)
 								{
-									if (node->segments.at(segment).is_available() && !has_deadlock(node, train.segment(), train.direction))
+									if (node->occupancy->is_available(segment))
 									{
-										node->segments.at(train.segment()).train_departured();
-
-										if (has_end)
-										{
-											train.move(train.end);
-										}
-										else
+										if (!has_deadlock(node, train.segment(), train.direction))
 										{
-											train.move(segment);
-										}
+											node->modify_occupancy().train_departured(train.segment());
+
+											const auto next_segment = (has_end ? train.end : segment);
+
+											node->trains.move(position, next_segment, 
+												m_network->segment(next_segment).standard_time(train.type, train.direction));
 
-										node->segments.at(train.segment()).train_arrived();
+											node->modify_occupancy().train_arrived(train.segment());
 
-										node->has_event = true;
+											node->has_event = true;
+										}
 
 										break;
 									}
@@ -601,8 +1986,6 @@ namespace solution
 								throw std::runtime_error("unknown direction");
 							}
 							}
-
-							train.stay(node->segments.at(train.segment()).standard_time(train.type, train.direction));
 						}
 
 						break;
@@ -617,6 +2000,21 @@ namespace solution
 					}
 					}
 				}
+
+				// then all trains tick forward, the moved ones on their new
+				// segments, in one flat loop over the lanes of the trains
+
+				auto deviation = node->trains.stay();
+
+				// a route held out of the network is charged as if its train
+				// were already late, otherwise blocking its start would be free
+
+				for (auto route : node->pending_routes)
+				{
+					deviation += m_routes[route].train.priority;
+				}
+
+				node->deviation += deviation;
 			}
 			catch (const std::exception & exception)
 			{
@@ -624,103 +2022,188 @@ namespace solution
 			}
 		}
 
-		bool System::has_deadlock(Node * node, std::string segment, Direction direction) const
+		bool System::has_deadlock(const Node * node, std::size_t segment, Direction direction) const
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				switch (direction)
-				{
-				case Direction::north:
+				for (auto step = 0U; step < std::size(m_network->segments()); ++step)
 				{
-					while (true)
-					{
-						auto available_segment = 
-							node->segments.at(segment).northern_adjacent_segments().front();
+					const auto & chain = m_network->chain(segment, direction);
 
-						if (std::size(node->segments.at(segment).northern_adjacent_segments()) > 1U)
+					for (const auto s : chain.segments)
+					{
+						if (!node->occupancy->is_available(s))
 						{
-							auto counter = 0U;
+							return true;
+						}
+					}
 
-							for (const auto & s : node->segments.at(segment).northern_adjacent_segments())
-							{
-								if (node->segments.at(s).is_available())
-								{
-									available_segment = s;
+					if (chain.end == Network::npos)
+					{
+						return false;
+					}
 
-									++counter;
-								}
-							}
+					const auto & segments = m_network->segment(chain.end).adjacent_segments(direction);
 
-							if (counter >= 2)
-							{
-								return false;
-							}
-							else if (counter == 0U)
-							{
-								return true;
-							}
-						}
+					if (segments.empty())
+					{
+						return false;
+					}
 
-						segment = available_segment;
+					auto counter = 0U;
 
-						if (!node->segments.at(segment).is_available())
+					for (const auto s : segments)
+					{
+						if (node->occupancy->is_available(s))
 						{
-							return true;
+							segment = s;
+
+							++counter;
 						}
 					}
 
-					break;
+					if (counter >= 2U)
+					{
+						return false;
+					}
+					else if (counter == 0U)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		bool System::is_held(const Node * node, const Train & train) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (m_affected_routes[train.index])
+				{
+					return false;
+				}
+
+				for (const auto & [segment, departure] : m_plan[train.index])
+				{
+					if (segment == train.segment())
+					{
+						return (node->time + 1LL < departure);
+					}
+				}
+
+				return false;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::make_new_nodes(Node * node, std::size_t index, children_container_t & children) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (is_dominated(Child{ node, index, 0U, node->deviation, 0U }, children))
+				{
+					return;
 				}
-				case Direction::south:
+
+				make_commands(node);
+
+				const auto size = (std::size_t(1U) << std::size(node->branches));
+
+				for (auto mask = std::size_t(0U); mask < size; ++mask)
 				{
-					while (true)
+					Child child{ node, index, mask, make_deviation(node, mask), 0U };
+
+					if (is_dominated(child, children))
 					{
-						auto available_segment =
-							node->segments.at(segment).southern_adjacent_segments().front();
+						continue;
+					}
 
-						if (std::size(node->segments.at(segment).southern_adjacent_segments()) > 1U)
-						{
-							auto counter = 0U;
+					child.signature = make_signature(node, mask);
 
-							for (const auto & s : node->segments.at(segment).southern_adjacent_segments())
-							{
-								if (node->segments.at(s).is_available())
-								{
-									available_segment = s;
+					push_child(std::move(child), children);
+				}
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
 
-									++counter;
-								}
-							}
+		// the common commands are written into the trains of the node, the
+		// trains, which may either move or wait, are recorded as branches,
+		// a wait lasts one tick, so that the waiting trains decide again
 
-							if (counter >= 2)
-							{
-								return false;
-							}
-							else if (counter == 0U)
-							{
-								return true;
-							}
-						}
+		void System::make_commands(Node * node) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				node->branches.clear();
 
-						segment = available_segment;
+				for (auto position = 0U; position < std::size(node->trains); ++position)
+				{
+					auto & train = node->trains[position];
 
-						if (!node->segments.at(segment).is_available())
+					if (node->trains.has_completed_route(position))
+					{
+						train.command = Train::Command::skip;
+					}
+					else if (!node->trains.is_ready(position) || is_held(node, train))
+					{
+						train.command = Train::Command::stay;
+					}
+					else
+					{
+						if ((std::size(node->branches) < m_branches_limit) && m_affected_routes[train.index])
 						{
-							return true;
+							node->branches.push_back(position);
 						}
-					}
 
-					break;
+						train.command = Train::Command::move;
+					}
 				}
-				default:
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		bool System::is_dominated(const Child & child, const children_container_t & children) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if (std::size(children) < m_strategies_limit)
 				{
-					throw std::runtime_error("unknown direction");
+					return false;
 				}
+
+				const auto is_dominated = !compare_children(child, children.front());
+
+				if (is_dominated)
+				{
+					m_has_truncated_frontier.store(true);
 				}
 
-				return false;
+				return is_dominated;
 			}
 			catch (const std::exception & exception)
 			{
@@ -728,93 +2211,234 @@ namespace solution
 			}
 		}
 
-		void System::make_new_nodes(Node * node)
+		void System::push_child(Child && child, children_container_t & children) const
 		{
 			RUN_LOGGER(logger);
 
 			try
 			{
-				std::vector < trains_container_t > variants;
+				for (auto & other : children)
+				{
+					if (other.signature == child.signature && has_same_state(other, child))
+					{
+						if (compare_children(child, other))
+						{
+							other = std::move(child);
 
-				variants.push_back(node->trains);
+							std::make_heap(std::begin(children), std::end(children), compare_children);
+						}
 
-				auto index = 0U;
+						return;
+					}
+				}
 
-				for (const auto & train : node->trains)
+				if (std::size(children) == m_strategies_limit)
 				{
-					const auto standard_time = 
-						node->segments.at(train.segment()).standard_time(train.type, train.direction);
+					std::pop_heap(std::begin(children), std::end(children), compare_children);
 
-					if (train.has_completed_route(standard_time))
-					{
-						for (auto & variant : variants)
-						{
-							variant[index].command = Train::Command::skip;
-						}
+					children.pop_back();
 
-						++index;
+					m_has_truncated_frontier.store(true);
+				}
 
-						continue;
+				children.push_back(std::move(child));
+
+				std::push_heap(std::begin(children), std::end(children), compare_children);
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		// deviation of the child, which is the deviation of the node and the
+		// lateness added by the trains, which wait instead of moving
+
+		double System::make_deviation(const Node * node, std::size_t mask) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				auto deviation = node->deviation;
+
+				for (auto i = 0U; i < std::size(node->branches); ++i)
+				{
+					if ((mask >> i) & 1U)
+					{
+						const auto position = node->branches[i];
+
+						deviation += node->trains[position].priority * static_cast < double > (std::max < std::time_t > (
+							node->trains.segment_time(position) + 1LL - node->trains.standard_time(position), 0LL));
 					}
+				}
+
+				return deviation;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		std::size_t System::make_signature(const Node * node, std::size_t mask) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				std::size_t signature = node->completed_routes_counter;
+
+				for (auto route : node->pending_routes)
+				{
+					aim::hash_combine(signature, route);
+				}
+
+				for (auto position = 0U; position < std::size(node->trains); ++position)
+				{
+					const auto & train = node->trains[position];
+
+					aim::hash_combine(signature, train.index);
+					aim::hash_combine(signature, train.segment());
+					aim::hash_combine(signature, static_cast < std::size_t > (node->trains.segment_time(position)));
+					aim::hash_combine(signature, static_cast < std::size_t > (node->command(position, mask)));
+				}
+
+				return signature;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		bool System::has_same_state(const Child & lhs, const Child & rhs) const
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				if ((m_settings.variants_limit > 1U) && (lhs.parent != rhs.parent) && 
+					(lhs.parent->completed_routes_counter == std::size(m_routes)))
+				{
+					return false;
+				}
+
+				if ((lhs.parent->completed_routes_counter != rhs.parent->completed_routes_counter) ||
+					(lhs.parent->pending_routes != rhs.parent->pending_routes) ||
+					(std::size(lhs.parent->trains) != std::size(rhs.parent->trains)))
+				{
+					return false;
+				}
+
+				for (auto position = 0U; position < std::size(lhs.parent->trains); ++position)
+				{
+					const auto & lhs_train = lhs.parent->trains[position];
+					const auto & rhs_train = rhs.parent->trains[position];
 
-					if (!train.is_ready(standard_time))
+					if ((lhs_train.index != rhs_train.index) || (lhs_train.segment() != rhs_train.segment()) ||
+						(lhs.parent->trains.segment_time(position) != rhs.parent->trains.segment_time(position)) ||
+						(lhs.parent->command(position, lhs.variant_index) != rhs.parent->command(position, rhs.variant_index)))
 					{
-						for (auto & variant : variants)
-						{
-							variant[index].command = Train::Command::stay;
-						}
+						return false;
 					}
-					else
+				}
+
+				return true;
+			}
+			catch (const std::exception & exception)
+			{
+				shared::catch_handler < system_exception > (logger, exception);
+			}
+		}
+
+		void System::make_leafs(const leafs_container_t & leafs, std::vector < children_container_t > & children)
+		{
+			RUN_LOGGER(logger);
+
+			try
+			{
+				children_container_t candidates;
+
+				std::unordered_map < std::size_t, std::size_t > transpositions;
+
+				for (auto & buffer : children)
+				{
+					for (auto & child : buffer)
 					{
-						if ((train.command == Train::Command::wait) && (!node->has_event))
-						{
-							++index;
+						const auto [iterator, is_inserted] = transpositions.emplace(child.signature, std::size(candidates));
 
-							continue;
-						}
-						else
+						if (!is_inserted && has_same_state(candidates[iterator->second], child))
 						{
-							auto size = std::size(variants);
-
-							for (auto i = 0U; i < size; ++i)
+							if (compare_children(child, candidates[iterator->second]))
 							{
-								variants[i][index].command = Train::Command::move;
+								candidates[iterator->second] = std::move(child);
 							}
 						}
+						else
+						{
+							candidates.push_back(std::move(child));
+						}
 					}
+				}
+
+				if (std::size(candidates) > m_strategies_limit)
+				{
+					std::nth_element(std::begin(candidates), 
+						std::next(std::begin(candidates), m_strategies_limit - 1U), std::end(candidates), compare_children);
+
+					candidates.erase(std::next(std::begin(candidates), m_strategies_limit), std::end(candidates));
 
-					++index;
+					m_has_truncated_frontier.store(true);
 				}
 
-				for (const auto & variant : variants)
+				std::sort(std::begin(candidates), std::end(candidates), compare_children);
+
+				std::vector < std::size_t > counters(std::size(leafs), 0U);
+
+				for (const auto & candidate : candidates)
 				{
-					auto new_node = new Node;
+					++counters[candidate.parent_index];
+				}
 
-					new_node->segments = node->segments;
-					new_node->trains = variant;
-					new_node->deviation = node->deviation;
-					new_node->parent = node;
-					new_node->completed_routes_counter = node->completed_routes_counter;
+				for (auto & candidate : candidates)
+				{
+					auto parent = candidate.parent;
 
-					node->children.push_back(new_node);
+					auto node = m_nodes.create();
 
-					m_leafs.push_back(new_node);
+					node->occupancy = parent->occupancy;
+					node->has_shared_occupancy = (counters[candidate.parent_index] > 1U) || parent->has_shared_occupancy;
+					node->trains = parent->trains;
+					node->commands.reserve(std::size(node->trains));
+					node->deviation = parent->deviation;
+					node->lost_routes = parent->lost_routes;
+					node->parent = parent;
+					node->completed_routes_counter = parent->completed_routes_counter;
+					node->pending_routes = parent->pending_routes;
 
-					if (std::size(m_leafs) > strategies_limit)
+					for (auto position = 0U; position < std::size(node->trains); ++position)
 					{
-						std::sort(std::begin(m_leafs), std::end(m_leafs),
-							[](const auto & lhs, const auto & rhs) { return (lhs->deviation < rhs->deviation); });
+						node->trains[position].command = parent->command(position, candidate.variant_index);
 
-						for (auto i = strategies_limit; i < std::size(m_leafs); ++i)
-						{
-							clear(m_leafs[i]);
-						}
-
-						m_leafs.erase(std::next(std::begin(m_leafs), strategies_limit), std::end(m_leafs));
+						node->commands.push_back(node->trains[position].command);
 					}
+
+					parent->children.push_back(node);
+
+					m_leafs.push_back(node);
 				}
 
-				node->segments.clear();
+				for (auto node : leafs)
+				{
+					node->occupancy.reset();
+
+					trains_container_t().swap(node->trains);
+
+					std::vector < std::size_t > ().swap(node->pending_routes);
+
+					std::vector < std::size_t > ().swap(node->branches);
+				}
 			}
 			catch (const std::exception & exception)
 			{
@@ -828,7 +2452,11 @@ namespace solution
 
 			try
 			{
-				clear(m_head);
+				m_leafs.clear();
+
+				m_head = nullptr;
+
+				m_nodes.clear();
 			}
 			catch (const std::exception & exception)
 			{
@@ -9,27 +9,45 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cmath>
 #include <deque>
 #include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <queue>
+#include <random>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
 #include "agents/train/train.hpp"
+#include "agents/trains/trains.hpp"
 #include "config/config.hpp"
+#include "memory/arena/arena.hpp"
+#include "module/network/network.hpp"
+#include "module/occupancy/occupancy.hpp"
 #include "module/segment/segment.hpp"
 
+#include "../common/aihash.h"
 #include "../common/zsheader.hpp"
 
 #include "../../../shared/source/logger/logger.hpp"
@@ -57,30 +75,51 @@ namespace solution
 		{
 		private:
 
-			using input_segments_t = Graph;
-
 			using input_routes_t = std::vector < NitkaID > ;
 
 			using input_locks_t = std::vector < Zapret > ;
 
 			using Segment = module::Segment;
 
-			using segments_container_t = std::unordered_map < std::string, Segment > ;
+			using Network = module::Network;
+
+			using Occupancy = module::Occupancy;
 
 			using Train = agents::Train;
 
-			using trains_container_t = std::vector < Train > ;
+			using trains_container_t = agents::Trains;
+
+		private:
+
+			struct Route
+			{
+				std::time_t start;
+
+				std::string type;
 
-			using routes_container_t = std::vector < std::pair < std::time_t, Train > > ;
+				Train train;
+
+				std::time_t standard_time;
+
+				std::size_t distances;
+			};
+
+		private:
+
+			using routes_container_t = std::vector < Route > ;
 
 		private:
 
+			// each input lock is compiled into two events, locking and unlocking
+			// of the segment, kept in order of time for all nodes at once
+
 			struct Lock
 			{
-				std::string segment;
+				std::time_t time;
+
+				std::size_t segment;
 
-				std::time_t begin;
-				std::time_t end;
+				bool is_locked;
 			};
 
 		private:
@@ -91,9 +130,27 @@ namespace solution
 
 			struct Node
 			{
-				void update_deviation();
+				Occupancy & modify_occupancy();
+
+				// command of the train in the variant given by the mask, where
+				// the branching trains wait for the set bits and move otherwise
+
+				Train::Command command(std::size_t position, std::size_t mask) const noexcept
+				{
+					for (auto i = 0U; i < std::size(branches); ++i)
+					{
+						if (branches[i] == position)
+						{
+							return (((mask >> i) & 1U) ? Train::Command::wait : Train::Command::move);
+						}
+					}
+
+					return trains[position].command;
+				}
 
-				segments_container_t segments;
+				std::shared_ptr < Occupancy > occupancy;
+
+				bool has_shared_occupancy = false;
 
 				trains_container_t trains;
 
@@ -106,10 +163,70 @@ namespace solution
 				std::vector < Node * > children;
 
 				std::size_t completed_routes_counter = 0U;
+
+				std::time_t time = 0LL;
+
+				std::vector < std::size_t > pending_routes;
+
+				std::size_t lost_routes = 0U;
+
+				std::vector < Train::Command > commands;
+
+				std::vector < std::size_t > branches;
 			};
 
 		private:
 
+			using nodes_arena_t = memory::Arena < Node > ;
+
+			using leafs_container_t = std::deque < Node * > ;
+
+		private:
+
+			struct Child
+			{
+				Node * parent;
+
+				std::size_t parent_index;
+				std::size_t variant_index;
+
+				double deviation;
+
+				std::size_t signature;
+			};
+
+		private:
+
+			using children_container_t = std::vector < Child > ;
+
+		private:
+
+			// node of the tree of the monte carlo search, which keeps only the
+			// statistics of the decisions, the states are rebuilt by rollouts
+
+			struct Decision
+			{
+				std::size_t visits = 0U;
+
+				double value = 0.0;
+
+				std::vector < std::size_t > children;
+			};
+
+		private:
+
+			using decisions_container_t = std::deque < Decision > ;
+
+		private:
+
+			static bool compare_children(const Child & lhs, const Child & rhs) noexcept
+			{
+				return (std::make_tuple(lhs.parent->lost_routes, lhs.deviation, lhs.parent_index, lhs.variant_index) <
+					std::make_tuple(rhs.parent->lost_routes, rhs.deviation, rhs.parent_index, rhs.variant_index));
+			}
+
+		public:
+
 			struct Point
 			{
 				std::string segment;
@@ -117,7 +234,7 @@ namespace solution
 				std::time_t time;
 			};
 
-		private:
+		public:
 
 			struct Chart
 			{
@@ -128,20 +245,39 @@ namespace solution
 				double priority = 0.0;
 
 				std::vector < Point > points;
+
+				std::vector < std::time_t > waits;
 			};
 
-		private:
+		public:
 
 			using charts_container_t = std::vector < Chart > ;
 
+		public:
+
+			using route_key_t = std::tuple < std::time_t, std::string, std::size_t, std::size_t > ;
+
+			using plan_t = std::map < route_key_t, Chart > ;
+
+		private:
+
+			using departures_container_t = std::vector < std::pair < std::size_t, std::time_t > > ;
+
 		public:
 
 			explicit System(
-				const input_segments_t & input_segments, 
-				const input_routes_t   & input_routes,
-				const input_locks_t    & input_locks) : m_time_begin(0LL), m_head(nullptr), m_done_flag(false)
+				std::shared_ptr < const Network > network,
+				const input_routes_t & input_routes,
+				const input_locks_t  & input_locks, 
+				const Settings & settings = Settings(),
+				const plan_t & plan = plan_t()) : 
+					m_network(network), m_settings(settings), m_strategies_limit(settings.strategies_limit), 
+					m_branches_limit(settings.branches_limit), m_horizon_limit(static_cast < std::time_t > (settings.horizon_limit)), 
+					m_deadline(std::chrono::steady_clock::time_point::max()), 
+					m_time_begin(0LL), m_head(nullptr), m_has_partial_charts(false), m_is_region(false), 
+					m_done_flag(false), m_has_truncated_frontier(false)
 			{
-				initialize(input_segments, input_routes, input_locks);
+				initialize(input_routes, input_locks, plan);
 			}
 
 			~System() noexcept
@@ -159,58 +295,130 @@ namespace solution
 		private:
 
 			void initialize(
-				const input_segments_t & input_segments,
-				const input_routes_t   & input_routes,
-				const input_locks_t    & input_locks);
+				const input_routes_t & input_routes,
+				const input_locks_t  & input_locks,
+				const plan_t & plan);
 
 			void uninitialize();
 
 		private:
 
-			void make_segments(const input_segments_t & input_segments);
-
 			void make_routes(const input_routes_t & input_routes);
 
 			void make_locks(const input_locks_t & input_locks);
 
-		private:
+			void make_plan(const plan_t & plan);
 
-			Direction get_direction(const std::string & begin, const std::string & end) const;
+			void make_regions(
+				const input_routes_t & input_routes,
+				const input_locks_t  & input_locks,
+				const plan_t & plan);
+
+			route_key_t make_route_key(const Route & route) const;
+
+			departures_container_t make_departures(const Chart & chart) const;
+
+			bool update_affected_routes();
 
 		private:
 
+			void make_head();
+
 			void clear(Node * node);
 
+			void cut_branch(Node * node);
+
 		public:
 
-			const auto & charts() const noexcept
+			charts_container_t charts() const
 			{
+				std::scoped_lock lock(m_mutex);
+
 				return m_charts;
 			}
 
+			plan_t plan() const;
+
+			std::vector < charts_container_t > variants() const
+			{
+				std::scoped_lock lock(m_mutex);
+
+				return m_variants;
+			}
+
 		public:
 
 			void run();
 
 		private:
 
-			void make_tree();
+			void run_regions();
+
+			bool make_tree();
+
+			void search();
+
+			std::pair < std::size_t, double > simulate(
+				const std::function < std::size_t(std::size_t) > & choose, charts_container_t * charts) const;
+
+			void improve();
+
+			std::vector < std::size_t > make_neighbourhood(std::mt19937 & engine) const;
+
+			bool has_expired() const noexcept
+			{
+				return (std::chrono::steady_clock::now() >= m_deadline);
+			}
 
 			void make_charts();
 
+			void commit(std::time_t time);
+
+			charts_container_t replay(const Node * leaf) const;
+
+			void record(const Node * state, std::time_t last_time, charts_container_t & charts) const;
+
+			bool has_completed_variants() const;
+
 		private:
 
 			void cut_tree(Node * node, const std::set < Node * > & required_nodes);
 
+			std::time_t get_next_event(std::time_t time) const;
+
+			std::time_t get_quiet_duration(std::time_t time) const;
+
+			std::time_t get_quiet_duration(const Node * node, std::time_t duration) const;
+
+			void advance(Node * node, std::time_t duration) const;
+
+			std::size_t get_lost_routes(std::time_t time, const Node * node) const;
+
 			void make_trains(std::time_t time, Node * node) const;
 
 			void update_segments(std::time_t time, Node * node) const;
 
 			void execute_commands(Node * node) const;
 
-			bool has_deadlock(Node * node, std::string segment, Direction direction) const;
+			bool has_deadlock(const Node * node, std::size_t segment, Direction direction) const;
+
+			bool is_held(const Node * node, const Train & train) const;
+
+			void make_new_nodes(Node * node, std::size_t index, children_container_t & children) const;
+
+			void make_commands(Node * node) const;
+
+			bool is_dominated(const Child & child, const children_container_t & children) const;
 
-			void make_new_nodes(Node * node);
+			void push_child(Child && child, children_container_t & children) const;
+
+			double make_deviation(const Node * node, std::size_t mask) const;
+
+			std::size_t make_signature(const Node * node, std::size_t mask) const;
+
+			bool has_same_state(const Child & lhs, const Child & rhs) const;
+
+			void make_leafs(const leafs_container_t & leafs, std::vector < children_container_t > & children);
 
 		public:
 
@@ -225,29 +433,69 @@ namespace solution
 
 			static const std::time_t seconds_in_minute = 60LL;
 
-			static const std::size_t strategies_limit = 4U;
+			static inline const double exploration = 0.7;
 
-			static const std::time_t time_limit = 1440U;
+			static inline const double waiting_probability = 0.02;
 
 		private:
 
-			segments_container_t m_segments;
+			std::shared_ptr < const Network > m_network;
+
+			const Settings m_settings;
+
+			std::size_t m_strategies_limit;
+
+			std::size_t m_branches_limit;
+
+			std::time_t m_horizon_limit;
+
+			std::chrono::steady_clock::time_point m_deadline;
 
 			routes_container_t m_routes;
 
+			std::vector < std::size_t > m_schedule;
+
+			std::vector < Network::distances_container_t > m_distances;
+
+			std::vector < departures_container_t > m_plan;
+
+			std::vector < bool > m_affected_routes;
+
+			std::vector < std::unique_ptr < System > > m_regions;
+
+			std::vector < std::vector < std::size_t > > m_regions_routes;
+
 			locks_container_t m_locks;
 
 			std::time_t m_time_begin;
 
+			Node m_origin;
+
+			nodes_arena_t m_nodes;
+
 			Node * m_head;
 
-			std::deque < Node * > m_leafs;
+			leafs_container_t m_leafs;
 
 			charts_container_t m_charts;
 
+			std::vector < charts_container_t > m_variants;
+
+			std::vector < std::pair < std::size_t, double > > m_variants_qualities;
+
+			std::pair < std::size_t, double > m_charts_quality;
+
+			bool m_has_partial_charts;
+
+			bool m_is_region;
+
 		private:
 
+			mutable std::mutex m_mutex;
+
 			mutable std::atomic < bool > m_done_flag;
+
+			mutable std::atomic < bool > m_has_truncated_frontier;
 		};
 
 	} // namespace plugin